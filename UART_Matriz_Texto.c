@@ -1,14 +1,24 @@
 #include <stdio.h>                          // Biblioteca padrão do C.
 #include <string.h>                         // Biblioteca padrão do C para manipulação de strings.
 #include <ctype.h>                          // Biblioteca para manipulação de caracteres
+#include <unistd.h>                         // sbrk(), usado no relatório de recursos
 #include "pico/stdlib.h"                    // Biblioteca padrão do Raspberry Pi Pico para controle de GPIO, temporização e comunicação serial.
 #include "pico/time.h"                      // Biblioteca para gerenciamento de temporizadores e alarmes.
 #include "hardware/i2c.h"                   // Biblioteca para comunicação I2C.
 #include "inc/ssd1306.h"                    // Biblioteca para controle do display OLED SSD1306.
 #include "inc/font.h"                       // Biblioteca para uso de fontes personalizadas.
-#include "hardware/pio.h"                   // Biblioteca para manipulação de periféricos PIO
-#include "ws2818b.pio.h"                    // Programa para controle de LEDs WS2812B
+#include "inc/matriz.h"                     // Biblioteca para controle da matriz de LEDs WS2812B
+#include "inc/ringbuf.h"                    // Fila circular para os caracteres recebidos
+#include "inc/eventos.h"                    // Fila de eventos entre as interrupções e o laço principal
+#include "inc/texto.h"                      // Modo texto: letreiro na matriz e terminal no display
+#include "inc/perf.h"                       // Medição de tempo das etapas (Ctrl+E)
+#include "inc/protocolo.h"                  // Quadros binários recebidos pela serial
+#include "inc/animacao.h"                   // Transições entre quadros na matriz
+#include "inc/botoes.h"                     // Botões com debounce, toque longo e repetição
+#include "inc/matriz_font.h"                // Caracteres 5x5 da matriz
 #include "hardware/clocks.h"                // Biblioteca para controle de relógios do hardware
+#include "pico/multicore.h"                 // Núcleo 1 para o modo de renderização dedicado
+#include "pico/util/queue.h"                // Fila entre os núcleos
 
 
 #define I2C_PORT i2c1
@@ -16,11 +26,22 @@
 #define I2C_SCL 15                          // Pinos GPIO para comunicação I2C
 #define endereco 0x3C                       // Endereço I2C do display OLED
 #define LED_PIN 7                           // Pino GPIO conectado a matriz de LEDs
-#define LED_COUNT 25                        // Número de LEDs na matriz
 //#define UART_ID uart0                       // Seleciona a UART0
 //#define BAUD_RATE 115200                    // Define a taxa de transmissão
 //#define UART_TX_PIN 0                       // Pino GPIO usado para TX
 //#define UART_RX_PIN 1                       // Pino GPIO usado para RX
+#ifndef RELATORIO_RECURSOS
+#define RELATORIO_RECURSOS 0                // 1: informa heap, tempo do alarme e tráfego a cada timeout
+#endif
+#define TEXTO_ALTERNA 0x14                  // Ctrl+T: liga/desliga o modo texto
+#define SNAPSHOT 0x10                       // Ctrl+P: imprime o display (PBM) e a matriz (PPM)
+#define PERF_RELATORIO 0x05                 // Ctrl+E: imprime os tempos (inc/perf.h), os eventos e o estado da entrada
+#define BRILHO_PASSO 16                     // Variação do brilho da matriz a cada '+' ou '-'
+#define ANIMACAO_TRANSICAO ANIM_SLIDE       // Transição entre caracteres na matriz
+#define ANIMACAO_PASSOS 8                   // Quadros de cada transição (a ANIMACAO_FPS)
+#ifndef MODO_DUAL_CORE
+#define MODO_DUAL_CORE 0                    // 1: núcleo 1 desenha display e matriz, núcleo 0 trata a entrada
+#endif
 
 const uint LED_VERDE = 11;                  // Define o pino GPIO 11 para controlar a cor verde do LED RGB.
 const uint LED_AZUL = 12;                   // Define o pino GPIO 12 para controlar a cor azul do LED RGB.
@@ -28,433 +49,291 @@ const uint LED_VERMELHO = 13;               // Define o pino GPIO 13 para contro
 const uint button_A = 5;                    // GPIO do botão A.
 const uint button_B = 6;                    // GPIO do botão B
 
-static volatile uint32_t last_time = 0;     // Armazena o tempo do último evento (em microssegundos)
-static volatile bool flag_button = 0;       // Armazena o estado do botão
 uint32_t elapsed_time = 10000;              // Armazena o tempo decorrido em microsegundos (Padrão: 10s)
-static int32_t set_button = 0;              // Controlador de seleção das frases
 alarm_id_t alarm_id = 0;                    // Variável global para armazenar o ID do alarme
+static ssd1306_t ssd;                       // Display usado pelo laço principal (envio assíncrono via DMA)
+static ringbuf_t rx_buffer;                 // Caracteres recebidos pela serial (preenchida na interrupção)
+static uint32_t rx_overflow_visto = 0;      // Último total de descartes já informado no terminal
+static uint32_t rx_pico = 0;                // Maior ocupação da fila de recepção vista pelo laço
+static uint8_t tela_padrao_quadro[WIDTH * HEIGHT / 8];  // Quadro pronto da tela padrão
+static volatile uint32_t timeout_irq_max_us = 0;        // Maior duração do alarme de timeout
+static bool modo_texto = false;             // Letreiro na matriz e terminal no display
+static struct repeating_timer texto_timer;  // Passo de taxa fixa do modo texto
+static uint8_t brilho = NP_BRILHO_PADRAO;   // Brilho global da matriz pedido pelo usuário
+
+// Chamada pelo stdio (em interrupção) quando há caracteres disponíveis: move tudo para a fila
+void rx_callback(void *param) {
+    int c;
+    bool recebeu = false;
+    while ((c = getchar_timeout_us(0)) >= 0) {
+        ringbuf_put(&rx_buffer, (uint8_t)c);
+        recebeu = true;
+    }
+    if (recebeu)
+        evento_post(EVENTO_RX, 0);
+}
+
+// Chamada (em interrupção) ao fim do envio de um quadro do display ou da matriz
+void quadro_callback(ssd1306_t *display, void *user_data) {
+    evento_post(EVENTO_QUADRO, 0);
+}
+
+void matriz_callback(void *user_data) {
+    evento_post(EVENTO_QUADRO, 1);
+}
+
+// Desenha a tela padrão uma única vez e guarda o quadro pronto para os próximos timeouts
+void monta_tela_padrao() {
+    bool cor = true;
+    ssd1306_fill(&ssd, !cor);                                           // Limpa o display
+    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                       // Desenha um retângulo
+    ssd1306_draw_string(&ssd, "Tarefa \t\t U4C6", 8, 10);               // Desenha uma string
+    ssd1306_draw_string(&ssd, "EMBARCATECH", 20, 30);                   // Desenha uma string
+    ssd1306_draw_string(&ssd, "Werliarlinson", 14, 48);                 // Desenha uma string
+    ssd1306_save_frame(&ssd, tela_padrao_quadro);                       // Guarda o quadro pronto
+}
 
-typedef struct pixel_t pixel_t;             // Alias para a estrutura pixel_t
-typedef pixel_t npLED_t;                    // Alias para facilitar o uso no contexto de LEDs
+// Comandos de desenho. Só executa_comando() acessa o display e a matriz; com MODO_DUAL_CORE
+// o núcleo 0 apenas publica os comandos e o núcleo 1 os executa.
+typedef enum {
+    RENDER_PADRAO,                          // Tela padrão e matriz apagada
+    RENDER_BOTAO,                           // Estado do LED de um botão (valor: 1 = verde, 2 = azul)
+    RENDER_CARACTERE,                       // Caractere recebido (valor: o caractere)
+    RENDER_TEXTO_INICIO,                    // Entra no modo texto: limpa letreiro e terminal
+    RENDER_TEXTO_TICK,                      // Um passo do modo texto
+    RENDER_TEXTO_FIM,                       // Sai do modo texto: descarta o texto pendente e o console
+    RENDER_SNAPSHOT,                        // Imprime o display e a matriz no terminal
+    RENDER_MENSAGEM,                        // Mensagem do protocolo (valor: proto_tipo_t)
+    RENDER_BRILHO,                          // Novo brilho global da matriz (valor: 0 a 255)
+    RENDER_ANIMACAO                         // Próximo quadro da animação da matriz
+} render_tipo_t;
+
+typedef struct {
+    uint8_t tipo;                           // Um dos valores de render_tipo_t
+    uint8_t valor;                          // Botão ou caractere
+    bool ligado;                            // Estado do LED (RENDER_BOTAO)
+    bool cor;                               // Cor da moldura; o fundo usa a cor oposta
+    uint16_t tamanho;                       // Dados da mensagem (RENDER_MENSAGEM)
+    const uint8_t *dados;
+} comando_t;
+
+// Comandos do modo texto e mensagens do protocolo desenham de forma incremental e o snapshot
+// lê o estado atual: nenhum deles pode ser descartado ou reordenado
+bool comando_incremental(const comando_t *cmd) {
+    return cmd->tipo >= RENDER_TEXTO_INICIO;
+}
+
+// Indica se o comando altera a matriz de LEDs (todos alteram o display)
+bool afeta_matriz(const comando_t *cmd) {
+    return cmd->tipo == RENDER_PADRAO || (cmd->tipo == RENDER_CARACTERE && isalnum(cmd->valor));
+}
 
-struct pixel_t { 
-    uint32_t G, R, B;                       // Componentes de cor: Verde, Vermelho e Azul
+// Sequência da tela padrão: quadros que se fecham até apagar a matriz
+static const uint32_t quadros_apaga[] = {
+    MATRIZ_GLYPH(0b11111, 0b10001, 0b10001, 0b10001, 0b11111),
+    MATRIZ_GLYPH(0b00000, 0b01110, 0b01010, 0b01110, 0b00000),
+    MATRIZ_GLYPH(0b00000, 0b00000, 0b00100, 0b00000, 0b00000),
+    0
 };
+static const anim_sequencia_t animacao_apaga = { quadros_apaga, count_of(quadros_apaga), ANIM_FADE, 4, 0 };
 
-npLED_t leds[LED_COUNT];                    // Array para armazenar o estado de cada LED
-PIO np_pio;                                 // Variável para referenciar a instância PIO usada
-uint sm;                                    // Variável para armazenar o número do state machine usado
+// Caractere recebido: um único quadro-chave, alcançado com ANIMACAO_TRANSICAO
+static uint32_t quadro_caractere;
+static const anim_sequencia_t animacao_caractere = { &quadro_caractere, 1, ANIMACAO_TRANSICAO, ANIMACAO_PASSOS, 0 };
 
-// Função para obter o índice de um LED na matriz
-int getIndex(int x, int y) {
-    // Se a linha for par (0, 2, 4), percorremos da esquerda para a direita.
-    // Se a linha for ímpar (1, 3), percorremos da direita para a esquerda.
-    if (y % 2 == 0) {
-        return 24-(y * 5 + x);              // Linha par (esquerda para direita).
+void render_matriz(const comando_t *cmd) {
+    if (cmd->tipo == RENDER_PADRAO) {
+        animacao_inicia(&animacao_apaga, 255, 0, 0);                    // Termina com a matriz apagada
     } else {
-        return 24-(y * 5 + (4 - x));        // Linha ímpar (direita para esquerda).
+        quadro_caractere = npGlyph(cmd->valor);                         // Número ou letra na matriz
+        animacao_inicia(&animacao_caractere, 255, 0, 0);
     }
+    animacao_tick();                                                    // Primeiro quadro já agora
 }
 
-// Função para inicializar o PIO para controle dos LEDs
-void npInit(uint pin) 
-{
-    uint offset = pio_add_program(pio0, &ws2818b_program);      // Carregar o programa PIO
-    np_pio = pio0;                                              // Usar o primeiro bloco PIO
-
-    sm = pio_claim_unused_sm(np_pio, false);                    // Tentar usar uma state machine do pio0
-    if (sm < 0)                                                 // Se não houver disponível no pio0
-    {
-        np_pio = pio1;                                          // Mudar para o pio1
-        sm = pio_claim_unused_sm(np_pio, true);                 // Usar uma state machine do pio1
-    }
+void render_display(const comando_t *cmd) {
+    bool cor = cmd->cor;
+    int c = cmd->valor;
 
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);    // Inicializar state machine para LEDs
-
-    for (uint i = 0; i < LED_COUNT; ++i)                        // Inicializar todos os LEDs como apagados
-    {
-        leds[i].R = 0;
-        leds[i].G = 0;
-        leds[i].B = 0;
+    if (cmd->tipo == RENDER_PADRAO) {
+        ssd1306_load_frame(&ssd, tela_padrao_quadro);                   // Restaura o quadro da tela padrão
+        ssd1306_send_data_async(&ssd);                                  // Atualiza o display
+        return;
     }
-}
 
-// Função para definir a cor de um LED específico
-void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) 
-{
-    leds[index].R = r;                                          // Definir componente vermelho
-    leds[index].G = g;                                          // Definir componente verde
-    leds[index].B = b;                                          // Definir componente azul
+    ssd1306_fill(&ssd, !cor);                                           // Limpa o display
+    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                       // Desenha um retângulo
+    if (cmd->tipo == RENDER_BOTAO) {
+        ssd1306_draw_string(&ssd, "Estado do LED", 12, 25);             // Desenha uma string
+        if (c == 1 && cmd->ligado)
+            ssd1306_draw_string(&ssd, "Verde Ligado!", 15, 35);
+        else if (c == 1)
+            ssd1306_draw_string(&ssd, "Verde Desligado", 5, 35);
+        else if (cmd->ligado)
+            ssd1306_draw_string(&ssd, "Azul Ligado!", 20, 35);
+        else
+            ssd1306_draw_string(&ssd, "Azul Desligado", 9, 35);
+    } else if (isdigit(c)) {                                            // Verifica se o caractere é um número
+        ssd1306_draw_string(&ssd, "Numero ", 20, 30);                   // Desenha uma string
+        ssd1306_draw_char(&ssd, c, 100, 30);                            // Desenha o caractere
+    } else if (isalpha(c)) {                                            // Verifica se o caractere é uma letra
+        ssd1306_draw_string(&ssd, "Caractere ", 20, 30);                // Desenha uma string
+        ssd1306_draw_char(&ssd, c, 100, 30);                            // Desenha o caractere
+    } else {
+        ssd1306_draw_string(&ssd, "Caractere nao", 12, 25);             // Desenha uma string
+        ssd1306_draw_string(&ssd, "suportado!", 25, 35);                // Desenha uma string
+    }
+    ssd1306_send_data_async(&ssd);                                      // Atualiza o display
 }
 
-// Função para limpar (apagar) todos os LEDs
-void npClear() 
-{
-    for (uint i = 0; i < LED_COUNT; ++i)                        // Iterar sobre todos os LEDs
-        npSetLED(i, 0, 0, 0);                                   // Definir cor como preta (apagado)
+// Desenha uma mensagem do protocolo já validada em trata_mensagem()
+void render_mensagem(const comando_t *cmd) {
+    const uint8_t *d = cmd->dados;
+    switch (cmd->valor) {
+        case PROTO_MATRIZ:
+            animacao_para();                                            // O quadro recebido assume a matriz
+            for (uint i = 0; i < LED_COUNT; i++, d += 3)
+                npSetPixel(i % MATRIZ_WIDTH, i / MATRIZ_WIDTH, d[0], d[1], d[2]);
+            npWrite();
+            break;
+        case PROTO_BLIT:
+            ssd1306_blit(&ssd, d[0], d[1], d[2], d[3], d + 4);
+            ssd1306_flush(&ssd);                                        // Envia só a região alterada
+            break;
+        case PROTO_TEXTO:
+            ssd1306_draw_string(&ssd, (const char *)d + 2, d[0], d[1]);
+            ssd1306_flush(&ssd);
+            break;
+    }
 }
 
-// Função para atualizar os LEDs no hardware
-void npWrite() 
-{
-    for (uint i = 0; i < LED_COUNT; ++i)                        // Iterar sobre todos os LEDs
-    {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G<<24);         // Enviar componente verde
-        pio_sm_put_blocking(np_pio, sm, leds[i].R<<24);         // Enviar componente vermelho
-        pio_sm_put_blocking(np_pio, sm, leds[i].B<<24);         // Enviar componente azul
+void executa_comando(const comando_t *cmd) {
+    if (cmd->tipo == RENDER_SNAPSHOT) {                                 // Fora da medição: só imprime
+        ssd1306_dump_pbm(&ssd);
+        npDumpPPM();
+        return;
     }
-}
 
-// Função para imprimir um frame na matriz de LEDs de maneira padronizada e sem dificuldades
-void print_frame(int frame[5][5][3])
-{
-    for(int linha = 0; linha < 5; linha++){
-        for(int coluna = 0; coluna < 5; coluna++){
-            int posicao = getIndex(linha, coluna);
-            npSetLED(posicao, frame[coluna][linha][0], frame[coluna][linha][1], frame[coluna][linha][2]);
-        }
+    PERF_BEGIN(PERF_RENDER);
+    switch (cmd->tipo) {
+        case RENDER_TEXTO_INICIO:
+            animacao_para();                                            // O letreiro assume a matriz
+            texto_reset();
+            break;
+        case RENDER_TEXTO_TICK:
+            texto_tick();
+            break;
+        case RENDER_TEXTO_FIM:
+            texto_fim();
+            break;
+        case RENDER_MENSAGEM:
+            render_mensagem(cmd);
+            break;
+        case RENDER_BRILHO:
+            npSetBrightness(cmd->valor);                                // Reaplica às cores atuais
+            npWrite();
+            break;
+        case RENDER_ANIMACAO:
+            animacao_tick();
+            break;
+        default:
+            if (afeta_matriz(cmd))
+                render_matriz(cmd);
+            render_display(cmd);
+            break;
     }
-    npWrite();
-    
+    PERF_END(PERF_RENDER);
 }
 
-// Função para imprimir a animação dos números árabicos
-void animation_number_ara(int number){
-
-    //Lista dos numeros arabicos
-    int number_1[5][5][3] = { //1
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int number_2[5][5][3] = { //2
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_3[5][5][3] = { //3
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_4[5][5][3] = { //4
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_5[5][5][3] = { //5
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_6[5][5][3] = { //6
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_7[5][5][3] = { //7
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_8[5][5][3] = { //8
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_9[5][5][3] = { //9
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int number_0[5][5][3] = { //0
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-
-    switch (number) {
-        case 0: print_frame(number_0); break;
-        case 1: print_frame(number_1); break;
-        case 2: print_frame(number_2); break;
-        case 3: print_frame(number_3); break;
-        case 4: print_frame(number_4); break;
-        case 5: print_frame(number_5); break;
-        case 6: print_frame(number_6); break;
-        case 7: print_frame(number_7); break;
-        case 8: print_frame(number_8); break;
-        case 9: print_frame(number_9); break;
-    }          
+#if MODO_DUAL_CORE
+static queue_t fila_render;                 // Comandos do núcleo 0 para o núcleo 1
+static comando_t display_pendente, matriz_pendente;
+static bool tem_display = false, tem_matriz = false;
+static volatile uint32_t mensagens_concluidas = 0;      // Mensagens do protocolo já desenhadas
+
+static void core1_descarrega() {
+    if (!tem_matriz && !tem_display)
+        return;
+    PERF_BEGIN(PERF_RENDER);
+    if (tem_matriz)
+        render_matriz(&matriz_pendente);
+    if (tem_display)
+        render_display(&display_pendente);
+    tem_matriz = tem_display = false;
+    PERF_END(PERF_RENDER);
+}
 
+// Lote do núcleo 1: cmd e todos os comandos já na fila. Executa só o último de cada saída:
+// cada comando redesenha a tela inteira (e a matriz, se a afetar), então os anteriores seriam
+// sobrescritos. A matriz e o display são independentes, logo o resultado é o mesmo da
+// execução em ordem de todos os comandos. Os comandos incrementais são executados em ordem,
+// depois de desenhado o que estava pendente antes deles.
+void core1_lote(comando_t cmd) {
+    do {
+        if (comando_incremental(&cmd)) {
+            core1_descarrega();
+            executa_comando(&cmd);
+            if (cmd.tipo == RENDER_MENSAGEM) {
+                __dmb();                                                // Terminou de ler os dados
+                mensagens_concluidas = mensagens_concluidas + 1;
+            }
+            continue;
+        }
+        display_pendente = cmd;
+        tem_display = true;
+        if (afeta_matriz(&cmd)) {
+            matriz_pendente = cmd;
+            tem_matriz = true;
+        }
+    } while (queue_try_remove(&fila_render, &cmd));
+    core1_descarrega();
 }
 
-// Função para imprimir a animação das letras maiúsculas
-void animation_letter(char letter) {
-    // Lista das letras maiúsculas
-    int letter_A[5][5][3] = { // A
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_B[5][5][3] = { // B
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_C[5][5][3] = { // C
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_D[5][5][3] = { // D
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_E[5][5][3] = { // E
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_F[5][5][3] = { // F
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_G[5][5][3] = { // G
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_H[5][5][3] = { // H
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_I[5][5][3] = { // I
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_J[5][5][3] = { // J
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_K[5][5][3] = { // K
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_L[5][5][3] = { // L
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_M[5][5][3] = { // M
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},}
-                };
-    int letter_N[5][5][3] = { // N
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},}
-                };
-    int letter_O[5][5][3] = { // O
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_P[5][5][3] = { // P
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_Q[5][5][3] = { // Q
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0},}
-                };
-    int letter_R[5][5][3] = { // R
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_S[5][5][3] = { // S
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_T[5][5][3] = { // T
-                {{55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_U[5][5][3] = { // U
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {0, 0, 0},}
-                };
-    int letter_V[5][5][3] = { // V
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_W[5][5][3] = { // W
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}},
-                {{55, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {55, 0, 0},}
-                };
-    int letter_X[5][5][3] = { // X
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}},
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},}
-                };
-    int letter_Y[5][5][3] = { // Y
-                {{55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0},},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0},}
-                };
-    int letter_Z[5][5][3] = { // Z
-                {{55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0},},
-                {{0, 0, 0}, {0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{0, 0, 0}, {55, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-                {{55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0}, {55, 0, 0},}
-                };
-
-    // Seleciona a letra correta com base no caractere recebido
-    switch(letter) {
-        case 'A': case 'a': print_frame(letter_A); break;
-        case 'B': case 'b': print_frame(letter_B); break;
-        case 'C': case 'c': print_frame(letter_C); break;
-        case 'D': case 'd': print_frame(letter_D); break;
-        case 'E': case 'e': print_frame(letter_E); break;
-        case 'F': case 'f': print_frame(letter_F); break;
-        case 'G': case 'g': print_frame(letter_G); break;
-        case 'H': case 'h': print_frame(letter_H); break;
-        case 'I': case 'i': print_frame(letter_I); break;
-        case 'J': case 'j': print_frame(letter_J); break;
-        case 'K': case 'k': print_frame(letter_K); break;
-        case 'L': case 'l': print_frame(letter_L); break;
-        case 'M': case 'm': print_frame(letter_M); break;
-        case 'N': case 'n': print_frame(letter_N); break;
-        case 'O': case 'o': print_frame(letter_O); break;
-        case 'P': case 'p': print_frame(letter_P); break;
-        case 'Q': case 'q': print_frame(letter_Q); break;
-        case 'R': case 'r': print_frame(letter_R); break;
-        case 'S': case 's': print_frame(letter_S); break;
-        case 'T': case 't': print_frame(letter_T); break;
-        case 'U': case 'u': print_frame(letter_U); break;
-        case 'V': case 'v': print_frame(letter_V); break;
-        case 'W': case 'w': print_frame(letter_W); break;
-        case 'X': case 'x': print_frame(letter_X); break;
-        case 'Y': case 'y': print_frame(letter_Y); break;
-        case 'Z': case 'z': print_frame(letter_Z); break;    
+// Laço do núcleo 1: dorme até chegar um comando e executa o lote que ele abre
+void core1_render() {
+    comando_t cmd;
+    perf_init();                                                        // SysTick do núcleo 1
+    while (true) {
+        queue_remove_blocking(&fila_render, &cmd);
+        core1_lote(cmd);
     }
 }
+#endif
+
+// Entrega um comando de desenho: ao núcleo 1 (MODO_DUAL_CORE) ou direto ao hardware
+void envia_comando(uint8_t tipo, uint8_t valor, bool ligado, bool cor) {
+    comando_t cmd = { .tipo = tipo, .valor = valor, .ligado = ligado, .cor = cor };
+#if MODO_DUAL_CORE
+    queue_add_blocking(&fila_render, &cmd);
+#else
+    executa_comando(&cmd);
+#endif
+}
 
-// Função para lidar com a interrupção dos botões
-void gpio_irq_handler(uint gpio, uint32_t events) {
-    
-    flag_button = true;                                                 // Ativa a flag para ignorar o botão
-
-    uint32_t current_time = to_us_since_boot(get_absolute_time());      // Obter o tempo atual em microssegundos
-
-    if(current_time - last_time > 300000) {                             // Ignorar eventos muito próximos
-       
-        last_time = current_time;
-        
-        if (gpio == button_B) {                                         // Avança para a próxima combinação
-            gpio_put(LED_AZUL, !gpio_get(LED_AZUL));                    // Inverte o estado do LED azul
-            set_button = 2;
-        } 
-        if (gpio == button_A) {                                         // Retrocede para a combinação anterior
-            gpio_put(LED_VERDE, !gpio_get(LED_VERDE));                  // Inverte o estado do LED verde
-            set_button = 1;
-        }
-    }
+// Muda o brilho global da matriz e redesenha o quadro atual com ele
+void ajusta_brilho(int valor) {
+    brilho = valor < 0 ? 0 : valor > 255 ? 255 : valor;
+    printf("Brilho da matriz: %u\r\n", brilho);
+    envia_comando(RENDER_BRILHO, brilho, false, true);
+}
+
+// Entrega uma mensagem do protocolo. Os dados estão no buffer do analisador, que o próximo
+// byte recebido sobrescreve: no MODO_DUAL_CORE espera o núcleo 1 desenhá-la antes de seguir.
+void envia_mensagem(const proto_msg_t *msg) {
+    comando_t cmd = { .tipo = RENDER_MENSAGEM, .valor = msg->tipo, .tamanho = msg->tamanho, .dados = msg->dados };
+#if MODO_DUAL_CORE
+    uint32_t alvo = mensagens_concluidas + 1;
+    queue_add_blocking(&fila_render, &cmd);
+    while (mensagens_concluidas != alvo)
+        tight_loop_contents();
+#else
+    executa_comando(&cmd);
+#endif
 }
 
 // Função de resetar as mensagens já escritas em tela para a configuração padrão.
-int64_t turn_off_callback(alarm_id_t id, void *user_data) {
-    
-    bool cor = true;
-    ssd1306_t ssd; // Inicializa a estrutura do display
-    ssd1306_init(&ssd, WIDTH, HEIGHT, false, endereco, I2C_PORT);       // Inicializa o display
-    ssd1306_config(&ssd);                                               // Configura o display
-    ssd1306_send_data(&ssd);                                            // Envia os dados para o display
+// Reaproveita o display já configurado e o quadro montado em monta_tela_padrao().
+void tela_padrao() {
 
     // Sequência de escape ANSI para limpar a tela do terminal
     const char *clear_screen = "\033[2J\033[H";
@@ -465,26 +344,226 @@ int64_t turn_off_callback(alarm_id_t id, void *user_data) {
     const char *init_message = "Digite algo e veja o que acontece:\r\n";
     //uart_puts(UART_ID, init_message);
     printf(init_message);
-    ssd1306_fill(&ssd, !cor);                                           // Limpa o display
-    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                       // Desenha um retângulo
-    ssd1306_draw_string(&ssd, "Tarefa \t\t U4C6", 8, 10);               // Desenha uma string
-    ssd1306_draw_string(&ssd, "EMBARCATECH", 20, 30);                   // Desenha uma string
-    ssd1306_draw_string(&ssd, "Werliarlinson", 14, 48);                 // Desenha uma string      
-    ssd1306_send_data(&ssd);                                            // Atualiza o display
-    
-    npClear();                                                          // Apagar todos os LEDs
-    npWrite();                                                          // Atualizar os LEDs no hardware
+    envia_comando(RENDER_PADRAO, 0, false, true);                       // Tela padrão e matriz apagada
 
     gpio_put(LED_VERDE, 0);                                             // Apaga o LED verde
     gpio_put(LED_AZUL, 0);                                              // Apaga o LED azul
+
+#if RELATORIO_RECURSOS
+    // O heap da Pico vai de `end` até __StackLimit (linker script) e cresce por sbrk(), sem
+    // depender de mallinfo(), obsoleta
+    extern char end, __StackLimit;
+    char *topo = sbrk(0);
+    printf("Heap: %u bytes tomados pelo malloc, %u livres ate a pilha | alarme de timeout: max %lu us\r\n",
+           (unsigned)(topo - &end), (unsigned)(&__StackLimit - topo), (unsigned long)timeout_irq_max_us);
+    np_stats_t np = npGetStats();
+    printf("Display: %lu bytes em %lu transacoes, %lu envios evitados | "
+           "matriz: %lu palavras em %lu quadros, %lu evitados\r\n",
+           (unsigned long)ssd.stats.bytes, (unsigned long)ssd.stats.transactions,
+           (unsigned long)ssd.stats.skipped,
+           (unsigned long)np.words, (unsigned long)np.frames, (unsigned long)np.skipped);
+#endif
+}
+
+// Alarme de inatividade: só avisa o laço principal, que redesenha a tela padrão
+int64_t turn_off_callback(alarm_id_t id, void *user_data) {
+    uint32_t inicio = time_us_32();
+    evento_post(EVENTO_TIMEOUT, 0);
+    uint32_t duracao = time_us_32() - inicio;                           // Tempo gasto em contexto de interrupção
+    if (duracao > timeout_irq_max_us)
+        timeout_irq_max_us = duracao;
     // Retorna 0 para indicar que o alarme não deve se repetir.
     return 0;
 }
 
-int main() {
-    
+// Passo do modo texto: só avisa o laço principal
+bool texto_tick_callback(struct repeating_timer *t) {
+    evento_post(EVENTO_TICK, 0);
+    return true;
+}
+
+// Trata um botão já filtrado pelo debounce (inc/botoes.h). Pressionar alterna o LED
+// correspondente; segurar A diminui e segurar B aumenta o brilho da matriz.
+void trata_botao(uint8_t dado, bool cor) {
+    int botao = botao_numero(dado);
+    botao_acao_t acao = botao_acao(dado);
+    if (acao == BOTAO_LONGO || acao == BOTAO_REPETE) {
+        ajusta_brilho(brilho + (botao == 1 ? -BRILHO_PASSO : BRILHO_PASSO));
+        return;
+    }
+    if (acao != BOTAO_PRESSIONADO)
+        return;
+    uint led = botao == 1 ? LED_VERDE : LED_AZUL;
+    bool ligado = !gpio_get(led);
+    gpio_put(led, ligado);
+    printf("Estado do LED %s %s!\r\n", botao == 1 ? "Verde" : "Azul",
+           ligado ? "Ligado" : "Desligado");                            // Imprime uma mensagem no terminal
+    if (modo_texto)                                                     // O display está com o terminal
+        return;
+    envia_comando(RENDER_BOTAO, botao, ligado, cor);
+    // Reseta o tempo de espera para a mensagem padrão
+    cancel_alarm(alarm_id);
+    // Timeout atingido, reseta a mensagem padrão
+    alarm_id = add_alarm_in_ms(elapsed_time, turn_off_callback, NULL, false);
+}
+
+// Trata um caractere recebido pela serial: atualiza a matriz, o display e ecoa no terminal
+void trata_caractere(int c, bool cor) {
+    if (!isalnum(c)) {
+        //uart_puts(UART_ID, "Caractere não suportado: ");                // Envia uma mensagem de erro
+        printf("Caractere não suportado: ");                            // Envia uma mensagem de erro
+    }
+    envia_comando(RENDER_CARACTERE, c, false, cor);
+    // Envia de volta o caractere lido (eco)
+    //uart_putc(UART_ID, c);
+    printf("%c", c);
+    // Envia uma mensagem adicional para cada caractere recebido
+    //uart_puts(UART_ID, " <- Eco do RP2\r\n");
+    printf(" <- Eco do RP2\r\n");
+    // Reseta o tempo de espera para a mensagem padrão
+    cancel_alarm(alarm_id);
+    // Timeout atingido, reseta a mensagem padrão
+    alarm_id = add_alarm_in_ms(elapsed_time, turn_off_callback, NULL, false);
+}
+
+// Liga ou desliga o modo texto. Enquanto ligado não há timeout de inatividade: o letreiro e
+// o terminal ficam na tela, e o passo de taxa fixa faz todo o desenho.
+void alterna_modo_texto() {
+    modo_texto = !modo_texto;
+    if (modo_texto) {
+        cancel_alarm(alarm_id);
+        printf("\r\nModo texto ligado (Ctrl+T para sair)\r\n");
+        envia_comando(RENDER_TEXTO_INICIO, 0, false, true);
+        add_repeating_timer_ms(-TEXTO_TICK_MS, texto_tick_callback, NULL, &texto_timer);
+    } else {
+        cancel_repeating_timer(&texto_timer);
+        envia_comando(RENDER_TEXTO_FIM, 0, false, true);
+        tela_padrao();
+    }
+}
+
+// Modo texto: enfileira o caractere para o letreiro e o terminal e ecoa sem mensagem extra
+void trata_texto(int c) {
+    texto_put(c);
+    if (c == '\r')
+        printf("\r\n");
+    else
+        printf("%c", c);
+}
+
+// Quadro válido do protocolo: confere o tamanho esperado para o tipo, executa e responde
+// PROTO_ACK (ou PROTO_NAK), o que permite ao computador controlar o fluxo.
+void trata_mensagem(const proto_msg_t *msg) {
+    const uint8_t *d = msg->dados;
+    uint32_t timeout = 0;
+    bool ok;
+    switch (msg->tipo) {
+        case PROTO_MATRIZ:
+            ok = msg->tamanho == 3 * LED_COUNT;
+            break;
+        case PROTO_BLIT:
+            ok = msg->tamanho >= 4 && msg->tamanho == 4 + d[2] * d[3];
+            break;
+        case PROTO_TEXTO:
+            ok = msg->tamanho >= 2;
+            break;
+        case PROTO_TIMEOUT:
+            if (msg->tamanho == 4)
+                timeout = d[0] | d[1] << 8 | d[2] << 16 | (uint32_t)d[3] << 24;
+            ok = timeout > 0;
+            break;
+        case PROTO_BRILHO:
+            ok = msg->tamanho == 1;
+            break;
+        default:
+            ok = false;
+            break;
+    }
+    if (!ok) {
+        putchar(PROTO_NAK);
+        return;
+    }
+
+    if (msg->tipo == PROTO_TIMEOUT)
+        elapsed_time = timeout;
+    else if (msg->tipo == PROTO_BRILHO)
+        ajusta_brilho(d[0]);
+    else
+        envia_mensagem(msg);
+    if (!modo_texto) {                                                  // Reinicia a contagem de inatividade
+        cancel_alarm(alarm_id);
+        alarm_id = add_alarm_in_ms(elapsed_time, turn_off_callback, NULL, false);
+    }
+    putchar(PROTO_ACK);
+}
+
+// Estado da entrada para o relatório do Ctrl+E: botões, fila de recepção, protocolo e matriz
+void relatorio_entrada() {
+    for (uint8_t b = 1; b <= BOTOES_MAX; b++)                          // Botão 1 é o A, 2 é o B
+        printf("Botao %c: %s, %lu bordas\r\n", 'A' + b - 1, botao_pressionado(b) ? "pressionado" : "solto",
+               (unsigned long)botao_bordas(b));
+    printf("Recepcao: pico de %lu de %u bytes na fila, %lu descartados | protocolo: %lu quadros com erro\r\n",
+           (unsigned long)rx_pico, RINGBUF_SIZE, (unsigned long)rx_buffer.overflow,
+           (unsigned long)protocolo_erros());
+    printf("Animacao da matriz: %s\r\n", animacao_ativa() ? "em andamento" : "parada");
+}
+
+// Byte recebido fora de um quadro do protocolo: comando de controle ou caractere
+void trata_livre(uint8_t byte, bool cor) {
+    if (byte == TEXTO_ALTERNA)
+        alterna_modo_texto();
+    else if (byte == SNAPSHOT)
+        envia_comando(RENDER_SNAPSHOT, 0, false, true);
+    else if (byte == PERF_RELATORIO) {
+        perf_dump();
+        evento_dump();
+        relatorio_entrada();
+    } else if (modo_texto)
+        trata_texto(byte);
+    else if (byte == '+' || byte == '-')
+        ajusta_brilho(brilho + (byte == '+' ? BRILHO_PASSO : -BRILHO_PASSO));
+    else
+        trata_caractere(byte, cor);
+}
+
+// Byte recebido pela serial. Quadros binários têm prioridade; um cabeçalho recusado devolve
+// os bytes retidos: o 0xA5 era texto, e os seguintes são analisados de novo, pois podem
+// começar um quadro verdadeiro.
+void trata_byte(uint8_t byte, bool cor) {
+    proto_msg_t msg;
+    switch (protocolo_byte(byte, &msg)) {
+        case PROTO_LIVRE:
+            trata_livre(byte, cor);
+            break;
+        case PROTO_PRONTO:
+            trata_mensagem(&msg);
+            break;
+        case PROTO_ERRO:
+            putchar(PROTO_NAK);
+            if (msg.tamanho)                                            // Timeout: o byte atual recomeça a análise
+                trata_byte(msg.dados[0], cor);
+            break;
+        case PROTO_DEVOLVE: {
+            uint8_t retidos[PROTO_CABECALHO];                           // protocolo_byte() reusa msg.dados
+            uint n = msg.tamanho;
+            memcpy(retidos, msg.dados, n);
+            trata_livre(retidos[0], cor);
+            for (uint i = 1; i < n; i++)
+                trata_byte(retidos[i], cor);
+            break;
+        }
+        case PROTO_OCUPADO:
+            break;
+    }
+}
+
+// Configura periféricos, display, matriz e botões e agenda a primeira tela padrão
+void inicializa() {
     // Inicializa a comunicação serial para permitir o uso de printf.
     stdio_init_all();
+    evento_init();                                                      // Antes de qualquer interrupção publicar
+    stdio_set_chars_available_callback(rx_callback, NULL);              // Recepção por interrupção
+    perf_init();                                                        // Instrumentação (se habilitada)
 
     //uart_init(UART_ID, BAUD_RATE);                                      // Inicializa a UART
     
@@ -494,11 +573,12 @@ int main() {
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);                          
     gpio_pull_up(I2C_SDA);                                              // Estabelece o pull-up na linha de dados
     gpio_pull_up(I2C_SCL);                                              // Estabelece o pull-up na linha de clock
-    ssd1306_t ssd;                                                      // Inicializa a estrutura do display
     ssd1306_init(&ssd, WIDTH, HEIGHT, false, endereco, I2C_PORT);       // Inicializa o display
     ssd1306_config(&ssd);                                               // Configura o display
     ssd1306_send_data(&ssd);                                            // Envia os dados para o display
 
+    monta_tela_padrao();                                                // Prepara o quadro da tela padrão
+
     // Limpa o display. O display inicia com todos os pixels apagados.
     ssd1306_fill(&ssd, false);
     ssd1306_send_data(&ssd);
@@ -515,129 +595,72 @@ int main() {
     gpio_init(LED_VERMELHO);
     gpio_set_dir(LED_VERMELHO, GPIO_OUT);
 
-    // Configura o pino dos butões como entrada digital.
-    gpio_init(button_A);
-    gpio_set_dir(button_A, GPIO_IN);
-    gpio_init(button_B);                                  
-    gpio_set_dir(button_B, GPIO_IN);
-    
-    // Habilita o resistor pull-up interno para o pino do botão.
-    // Isso garante que o pino seja lido como alto (3,3 V) quando o botão não está pressionado.
-    gpio_pull_up(button_A);
-    gpio_pull_up(button_B);
-
     npInit(LED_PIN);                                                    // Inicializar os LEDs
+    ssd1306_set_callback(&ssd, quadro_callback, NULL);                  // Fim de quadro vira evento
+    npSetCallback(matriz_callback, NULL);
     npClear();                                                          // Apagar todos os LEDs
     npWrite();                                                          // Atualizar os LEDs no hardware
+    texto_init(&ssd);                                                   // Modo texto usa o mesmo display
 
-    //Configuração da interrupção do botão A
-    gpio_set_irq_enabled_with_callback(button_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);   // Habilitar interrupção no botão A
-    //Configuração da interrupção do botão B
-    gpio_set_irq_enabled_with_callback(button_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);   // Habilitar interrupção no botão B
-    
-    bool cor = true;
+#if MODO_DUAL_CORE
+    queue_init(&fila_render, sizeof(comando_t), 16);                    // Fila de comandos para o núcleo 1
+    multicore_launch_core1(core1_render);                               // A partir daqui só o núcleo 1 desenha
+#endif
+
+    // Botões como entrada com pull-up e debounce por alarme; A é o botão 1 e B o botão 2
+    botoes_adiciona(button_A);
+    botoes_adiciona(button_B);
 
     add_alarm_in_ms(10, turn_off_callback, NULL, false);                // Aciona para começar a mensagem padrão
+}
 
-    // Loop principal do programa que verifica continuamente o estado do botão.
-    while (true) {
-        
-        cor = !cor;
-        
-        if(flag_button) {                                                                    // Evento para verificar o botão foi acionado
-            flag_button = false;                                                             // Reseta a flag
-            // Verifica se o botão foi pressionado (nível baixo no pino) para emissão da mensagem.
-            if (set_button == 1) {
-                //uart_puts(UART_ID,"Estado do LED Verde alterado!\r\n");                      // Imprime uma mensagem no terminal
-                if(gpio_get(LED_VERDE) == 1) {
-                    printf("Estado do LED Verde Ligado!\r\n");                                 // Imprime uma mensagem no terminal
-                    ssd1306_fill(&ssd, !cor);                                                    // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                                // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Estado do LED", 12, 25);                          // Desenha uma string
-                    ssd1306_draw_string(&ssd, "Verde Ligado!", 15, 35);                         // Desenha uma string
-                    ssd1306_send_data(&ssd);                                                     // Atualiza o display
-                } else {
-                    printf("Estado do LED Verde Desligado!\r\n");                               // Imprime uma mensagem no terminal
-                    ssd1306_fill(&ssd, !cor);                                                    // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                                // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Estado do LED", 12, 25);                          // Desenha uma string
-                    ssd1306_draw_string(&ssd, "Verde Desligado", 5, 35);                       // Desenha uma string
-                    ssd1306_send_data(&ssd);                                                     // Atualiza o display
-                }
-                
-            }
-            if (set_button == 2) {
-                //uart_puts(UART_ID,"Estado do LED Azul alterado!\r\n");                       // Imprime uma mensagem no terminal
-                if(gpio_get(LED_AZUL) == 1) {
-                    printf("Estado do LED Azul Ligado!\r\n");                                  // Imprime uma mensagem no terminal
-                    ssd1306_fill(&ssd, !cor);                                                    // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                                // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Estado do LED", 12, 25);                          // Desenha uma string
-                    ssd1306_draw_string(&ssd, "Azul Ligado!", 20, 35);                         // Desenha uma string
-                    ssd1306_send_data(&ssd);                                                     // Atualiza o display
-                } else {
-                    printf("Estado do LED Azul Desligado!\r\n");                                // Imprime uma mensagem no terminal
-                    ssd1306_fill(&ssd, !cor);                                                    // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                                // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Estado do LED", 12, 25);                          // Desenha uma string
-                    ssd1306_draw_string(&ssd, "Azul Desligado", 9, 35);                       // Desenha uma string
-                    ssd1306_send_data(&ssd);                                                     // Atualiza o display
-                }
-            }
-            set_button = 0;                                                                  // Reseta o valor do botão
-            // Reseta o tempo de espera para a mensagem padrão
-            cancel_alarm(alarm_id);
-            // Timeout atingido, reseta a mensagem padrão
-            alarm_id = add_alarm_in_ms(elapsed_time, turn_off_callback, NULL, false);
-        }    
-        
-        // Verifica se há dados disponíveis para leitura
-        if (stdio_usb_connected()) {
-            // Lê um caractere da UART
-            //int c = uart_getc(UART_ID);                                         // Lê um caractere da UART
-            int c = getchar_timeout_us(1); // Espera por um caractere com timeout de 1 microsegundos
-            if (c != PICO_ERROR_TIMEOUT) {
-                // Verifica se o caractere é um número
-                if (isdigit(c)) {                                                   // Verifica se o caractere é um número
-                    int number = c - '0';                                           // Converte o caractere para um número inteiro
-                    animation_number_ara(number);                                   // Chama a animação do número
-                    ssd1306_fill(&ssd, !cor);                                       // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                   // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Numero ", 20, 30);                   // Desenha uma string
-                    ssd1306_draw_char(&ssd, c, 100, 30);                            // Desenha o caractere
-                    ssd1306_send_data(&ssd);                                        // Atualiza o display
-                } else if (isalpha(c)) {                                            // Verifica se o caractere é uma letra
-                    animation_letter(c);                                            // Chama a animação da letra
-                    ssd1306_fill(&ssd, !cor);                                       // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                   // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Caractere ", 20, 30);                // Desenha uma string
-                    ssd1306_draw_char(&ssd, c, 100, 30);                            // Desenha o caractere
-                    ssd1306_send_data(&ssd);                                        // Atualiza o display
-                } else {
-                    //uart_puts(UART_ID, "Caractere não suportado: ");                // Envia uma mensagem de erro
-                    printf("Caractere não suportado: ");                            // Envia uma mensagem de erro
-                    ssd1306_fill(&ssd, !cor);                                       // Limpa o display
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, cor, !cor);                   // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, "Caractere nao", 12, 25);  // Desenha uma string
-                    ssd1306_draw_string(&ssd, "suportado!", 25, 35);  // Desenha uma string
-
-                    ssd1306_send_data(&ssd);                                        // Atualiza o display
-                }
-                // Envia de volta o caractere lido (eco)
-                //uart_putc(UART_ID, c);
-                printf("%c", c);
-                // Envia uma mensagem adicional para cada caractere recebido
-                //uart_puts(UART_ID, " <- Eco do RP2\r\n");
-                printf(" <- Eco do RP2\r\n");
-                // Reseta o tempo de espera para a mensagem padrão
-                cancel_alarm(alarm_id);
-                // Timeout atingido, reseta a mensagem padrão
-                alarm_id = add_alarm_in_ms(elapsed_time, turn_off_callback, NULL, false);
+// Trata um evento publicado por uma interrupção ou alarme. A cor da moldura alterna a cada evento.
+void trata_evento(const evento_t *ev) {
+    static bool cor = true;
+    cor = !cor;
+
+    switch (ev->tipo) {
+        case EVENTO_BOTAO:                                                  // Botão A ou B mudou
+            trata_botao(ev->dado, cor);
+            break;
+        case EVENTO_RX: {                                                   // Processa todos os caracteres recebidos
+            uint8_t byte;
+            PERF_BEGIN(PERF_ENTRADA);
+            if (ringbuf_count(&rx_buffer) > rx_pico)                        // Folga da fila, para o Ctrl+E
+                rx_pico = ringbuf_count(&rx_buffer);
+            while (ringbuf_get(&rx_buffer, &byte))
+                trata_byte(byte, cor);
+            PERF_END(PERF_ENTRADA);
+            if (rx_buffer.overflow != rx_overflow_visto) {                  // Avisa se a fila de recepção transbordou
+                rx_overflow_visto = rx_buffer.overflow;
+                printf("Fila de recepcao cheia: %lu bytes descartados\r\n", (unsigned long)rx_overflow_visto);
             }
+            break;
         }
-        // Introduz uma pequena pausa de 10 ms para reduzir o uso da CPU.
-        // Isso evita que o loop seja executado muito rapidamente e consuma recursos desnecessários.
-        sleep_ms(10);
+        case EVENTO_TIMEOUT:                                                // Inatividade: volta à tela padrão
+            if (!modo_texto)
+                tela_padrao();
+            break;
+        case EVENTO_TICK:                                                   // Passo do letreiro e do terminal
+            if (modo_texto)
+                envia_comando(RENDER_TEXTO_TICK, 0, false, true);
+            break;
+        case EVENTO_ANIMACAO:                                               // Próximo quadro da animação
+            envia_comando(RENDER_ANIMACAO, 0, false, true);
+            break;
+        case EVENTO_QUADRO:                                                 // Quadro entregue; nada pendente por ora
+            break;
+    }
+}
+
+int main() {
+    inicializa();
+
+    // Loop principal: dorme até que uma interrupção ou alarme publique um evento e o trata.
+    while (true) {
+        evento_t ev;
+        evento_wait(&ev);
+        trata_evento(&ev);
     }
 
     // Retorno de 0, que nunca será alcançado devido ao loop infinito.
@@ -0,0 +1,122 @@
+#include <string.h>
+#include "animacao.h"
+#include "matriz.h"
+#include "eventos.h"
+
+#define ANIM_LADO 5                         // Os quadros-chave têm 5x5 pixels
+
+static const anim_sequencia_t *seq = NULL;  // Sequência em reprodução (NULL: parada)
+static uint8_t cor[3];
+static uint8_t indice;                      // Quadro-chave de destino
+static uint passo;                          // Posição dentro da transição + pausa atuais (mesmo tipo de n)
+static uint8_t origem[ANIM_LADO][ANIM_LADO];    // Intensidades de onde a transição parte
+static uint8_t anterior[ANIM_LADO][ANIM_LADO];  // Intensidades do último quadro enviado
+static bool anterior_valido = false;
+static struct repeating_timer timer;
+static bool timer_ativo = false;
+
+static bool animacao_timer_callback(struct repeating_timer *t)
+{
+  evento_post(EVENTO_ANIMACAO, 0);
+  return true;
+}
+
+static inline uint8_t pixel(uint32_t quadro, uint x, uint y)
+{
+  return quadro & (1u << (5 * y + 4 - x)) ? 255 : 0;
+}
+
+// Intensidade (0 a 255) do pixel (x, y) no passo k de n da transição das intensidades a para
+// o quadro-chave b. A origem é um quadro de intensidades porque pode ser uma mistura: a
+// transição interrompida no meio de um fade continua do que estava na matriz.
+static uint8_t intensidade(uint8_t transicao, const uint8_t a[ANIM_LADO][ANIM_LADO], uint32_t b, uint k, uint n,
+                           uint x, uint y)
+{
+  uint desloc = k * ANIM_LADO / n;
+  switch (transicao) {
+    case ANIM_SLIDE:
+      return x + desloc < ANIM_LADO ? a[y][x + desloc] : pixel(b, x + desloc - ANIM_LADO, y);
+    case ANIM_WIPE:
+      return x < desloc ? pixel(b, x, y) : a[y][x];
+    case ANIM_FADE:
+      return (a[y][x] * (n - k) + pixel(b, x, y) * k) / n;
+    default:
+      return pixel(b, x, y);
+  }
+}
+
+// Começa a reproduzir seq a partir do quadro exibido agora, inclusive se for um quadro
+// intermediário de outra transição. anterior guarda só intensidades, então uma cor nova
+// invalida a comparação do próximo quadro com ele.
+void animacao_inicia(const anim_sequencia_t *nova, uint8_t r, uint8_t g, uint8_t b)
+{
+  seq = nova;
+  indice = 0;
+  passo = 0;
+  if (anterior_valido)
+    memcpy(origem, anterior, sizeof(origem));
+  else
+    memset(origem, 0, sizeof(origem));
+  if (cor[0] != r || cor[1] != g || cor[2] != b)
+    anterior_valido = false;                // Outra cor: o primeiro quadro é enviado mesmo igual
+  cor[0] = r;
+  cor[1] = g;
+  cor[2] = b;
+  if (!timer_ativo)
+    timer_ativo = add_repeating_timer_us(-1000000 / ANIMACAO_FPS, animacao_timer_callback, NULL, &timer);
+}
+
+// Interrompe a reprodução. Quem chama assume a matriz: o próximo início parte do vazio.
+void animacao_para()
+{
+  if (timer_ativo) {
+    cancel_repeating_timer(&timer);
+    timer_ativo = false;
+  }
+  seq = NULL;
+  anterior_valido = false;
+}
+
+bool animacao_ativa()
+{
+  return seq != NULL;
+}
+
+// Calcula o próximo quadro; o timer é desligado pelo mesmo núcleo que o liga, ao terminar
+void animacao_tick()
+{
+  if (!seq)
+    return;
+
+  uint32_t destino = seq->quadros[indice];
+  uint n = seq->passos ? seq->passos : 1;
+  uint k = passo < n ? passo + 1 : n;       // 1..n: o último passo já é o quadro-chave
+
+  uint8_t quadro[ANIM_LADO][ANIM_LADO];
+  for (uint y = 0; y < ANIM_LADO; y++)
+    for (uint x = 0; x < ANIM_LADO; x++)
+      quadro[y][x] = intensidade(seq->transicao, origem, destino, k, n, x, y);
+
+  if (!anterior_valido || memcmp(quadro, anterior, sizeof(quadro))) {
+    for (uint y = 0; y < ANIM_LADO && y < MATRIZ_HEIGHT; y++)
+      for (uint x = 0; x < ANIM_LADO && x < MATRIZ_WIDTH; x++)
+        npSetPixel(x, y, cor[0] * quadro[y][x] / 255, cor[1] * quadro[y][x] / 255, cor[2] * quadro[y][x] / 255);
+    npWrite();
+    memcpy(anterior, quadro, sizeof(quadro));
+    anterior_valido = true;
+  }
+
+  if (++passo < n + seq->pausa)
+    return;
+  for (uint y = 0; y < ANIM_LADO; y++)      // Quadro-chave alcançado: segue para o próximo
+    for (uint x = 0; x < ANIM_LADO; x++)
+      origem[y][x] = pixel(destino, x, y);
+  passo = 0;
+  if (++indice < seq->total)
+    return;
+  seq = NULL;
+  if (timer_ativo) {
+    cancel_repeating_timer(&timer);
+    timer_ativo = false;
+  }
+}
@@ -0,0 +1,28 @@
+#include "pico/stdlib.h"
+
+// Animações da matriz de LEDs. Uma sequência é uma lista de quadros-chave 5x5 no formato de
+// matriz_font (um uint32_t cada, em flash) com a transição usada para chegar a cada um. A
+// reprodução parte sempre do quadro exibido no momento, avança um quadro por
+// animacao_tick(), chamado por um alarme repetitivo a ANIMACAO_FPS, e só chama npWrite()
+// quando o quadro calculado difere do anterior.
+#define ANIMACAO_FPS 30                     // Taxa de quadros da reprodução
+
+typedef enum {
+  ANIM_CORTE,                               // Troca direta
+  ANIM_SLIDE,                               // O novo quadro entra pela direita empurrando o atual
+  ANIM_WIPE,                                // O novo quadro cobre o atual da esquerda para a direita
+  ANIM_FADE                                 // Mistura gradual de intensidade (inteiros)
+} anim_transicao_t;
+
+typedef struct {
+  const uint32_t *quadros;                  // Quadros-chave
+  uint8_t total;                            // Número de quadros-chave
+  uint8_t transicao;                        // anim_transicao_t usada entre quadros-chave
+  uint8_t passos;                           // Quadros gerados em cada transição
+  uint8_t pausa;                            // Quadros parados em cada quadro-chave
+} anim_sequencia_t;
+
+void animacao_inicia(const anim_sequencia_t *seq, uint8_t r, uint8_t g, uint8_t b);
+void animacao_para();
+bool animacao_ativa();
+void animacao_tick();
@@ -0,0 +1,159 @@
+#include "botoes.h"
+#include "eventos.h"
+#include "hardware/sync.h"
+
+#define DEBOUNCE_US (BOTAO_DEBOUNCE_MS * 1000)
+
+typedef struct {
+    uint32_t instante;                      // time_us_32() na interrupção
+    bool pressionado;                       // Nível lido logo após a borda
+} botao_borda_t;
+
+typedef enum {
+    FASE_LIVRE,                             // Nenhum alarme pendente
+    FASE_DEBOUNCE,                          // Esperando o sinal estabilizar
+    FASE_LONGO,                             // Pressionado, esperando BOTAO_LONGO_MS
+    FASE_REPETE                             // Pressionado, repetindo a cada BOTAO_REPETE_MS
+} botao_fase_t;
+
+typedef struct {
+    uint gpio;
+    uint8_t numero;
+    // Fila de bordas: head só é alterado pela interrupção do GPIO e tail só pelo alarme
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t perdidas;             // Bordas descartadas com a fila cheia
+    botao_borda_t bordas[BOTAO_BORDAS];
+    // Usados apenas nas interrupções do GPIO e do alarme, que rodam no mesmo núcleo e com
+    // a mesma prioridade, portanto nunca uma no meio da outra
+    uint8_t fase;
+    alarm_id_t alarme;
+    uint32_t ultima;                        // Instante da última borda retirada da fila
+    bool nivel;                             // Nível da última borda retirada da fila
+    uint32_t perdidas_vistas;
+    volatile bool estado;                   // Nível aceito após o debounce
+    volatile uint32_t total;                // Bordas recebidas desde botoes_adiciona()
+} botao_t;
+
+static botao_t botoes[BOTOES_MAX];
+static uint8_t quantidade = 0;
+
+static bool borda_put(botao_t *b, uint32_t instante, bool pressionado)
+{
+    uint32_t head = b->head;
+    if (head - b->tail >= BOTAO_BORDAS) {
+        b->perdidas++;
+        return false;
+    }
+    b->bordas[head & (BOTAO_BORDAS - 1)] = (botao_borda_t){ instante, pressionado };
+    __dmb();                                // A borda deve estar visível antes do novo índice
+    b->head = head + 1;
+    return true;
+}
+
+static bool borda_get(botao_t *b, botao_borda_t *borda)
+{
+    uint32_t tail = b->tail;
+    if (tail == b->head)
+        return false;
+    __dmb();
+    *borda = b->bordas[tail & (BOTAO_BORDAS - 1)];
+    __dmb();
+    b->tail = tail + 1;
+    return true;
+}
+
+// Alarme de um disparo de cada botão. O valor retornado o reagenda (> 0: a partir de agora,
+// < 0: a partir do disparo anterior, sem acumular atraso) ou o encerra (0).
+static int64_t botao_alarme(alarm_id_t id, void *user_data)
+{
+    botao_t *b = user_data;
+
+    if (b->fase == FASE_LONGO || b->fase == FASE_REPETE) {
+        evento_post(EVENTO_BOTAO, BOTAO_DADO(b->numero, b->fase == FASE_LONGO ? BOTAO_LONGO : BOTAO_REPETE));
+        b->fase = FASE_REPETE;
+        return -(int64_t)BOTAO_REPETE_MS * 1000;
+    }
+
+    botao_borda_t borda;
+    while (borda_get(b, &borda)) {
+        b->ultima = borda.instante;
+        b->nivel = borda.pressionado;
+    }
+    uint32_t quieto = time_us_32() - b->ultima;
+    if (quieto < DEBOUNCE_US)               // Houve borda durante a espera: recomeça a contar
+        return DEBOUNCE_US - quieto;
+    if (b->perdidas != b->perdidas_vistas) {
+        // A última borda pode ter sido descartada: o sinal já está estável, então lê o pino
+        b->perdidas_vistas = b->perdidas;
+        b->nivel = !gpio_get(b->gpio);
+    }
+
+    if (b->nivel != b->estado) {
+        b->estado = b->nivel;
+        evento_post(EVENTO_BOTAO, BOTAO_DADO(b->numero, b->nivel ? BOTAO_PRESSIONADO : BOTAO_SOLTO));
+        if (b->nivel) {                     // O tempo do toque longo conta desde a borda
+            b->fase = FASE_LONGO;
+            return (int64_t)BOTAO_LONGO_MS * 1000 - quieto;
+        }
+    }
+    b->fase = FASE_LIVRE;
+    b->alarme = 0;
+    return 0;
+}
+
+// Interrupção do GPIO: guarda a borda e garante que o alarme do botão esteja contando o
+// debounce. Toques longos e repetições pendentes são cancelados por qualquer borda.
+static void botoes_irq(uint gpio, uint32_t events)
+{
+    for (uint8_t i = 0; i < quantidade; i++) {
+        botao_t *b = &botoes[i];
+        if (b->gpio != gpio)
+            continue;
+        borda_put(b, time_us_32(), !gpio_get(gpio));
+        b->total++;
+        if (b->fase == FASE_DEBOUNCE)
+            return;
+        if (b->alarme > 0)
+            cancel_alarm(b->alarme);
+        b->fase = FASE_DEBOUNCE;
+        b->alarme = add_alarm_in_us(DEBOUNCE_US, botao_alarme, b, true);
+        if (b->alarme <= 0)                 // Sem alarmes livres: a próxima borda tenta de novo
+            b->fase = FASE_LIVRE;
+        return;
+    }
+}
+
+// Configura o pino com pull-up e interrupção nas duas bordas. Deve ser chamada no núcleo
+// que trata os alarmes padrão. Retorna o número do botão (1 a BOTOES_MAX) ou -1.
+int botoes_adiciona(uint gpio)
+{
+    if (quantidade == BOTOES_MAX)
+        return -1;
+
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+
+    botao_t *b = &botoes[quantidade];
+    b->gpio = gpio;
+    b->numero = quantidade + 1;
+    b->fase = FASE_LIVRE;
+    b->estado = !gpio_get(gpio);            // Um botão já pressionado no início não gera evento
+    quantidade++;
+
+    gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &botoes_irq);
+    return b->numero;
+}
+
+// Nível aceito pelo debounce
+bool botao_pressionado(uint8_t botao)
+{
+    return botao >= 1 && botao <= quantidade && botoes[botao - 1].estado;
+}
+
+// Bordas recebidas, incluindo os repiques filtrados
+uint32_t botao_bordas(uint8_t botao)
+{
+    return botao >= 1 && botao <= quantidade ? botoes[botao - 1].total : 0;
+}
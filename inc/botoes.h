@@ -0,0 +1,39 @@
+#include "pico/stdlib.h"
+
+// Botões com debounce por alarme. A interrupção do GPIO só registra a borda (instante e
+// nível) numa fila própria do botão e arma o alarme de um disparo dele; o alarme espera o
+// sinal ficar BOTAO_DEBOUNCE_MS sem bordas e publica EVENTO_BOTAO com o que mudou.
+// Os botões ligam o pino ao GND (pull-up interno): nível baixo = pressionado.
+#define BOTOES_MAX 2                        // Botões registrados com botoes_adiciona()
+#define BOTAO_BORDAS 32                     // Bordas guardadas entre dois alarmes; potência de 2
+#define BOTAO_DEBOUNCE_MS 20                // Tempo sem bordas para aceitar o novo nível
+#define BOTAO_LONGO_MS 600                  // Pressionado por este tempo: BOTAO_LONGO
+#define BOTAO_REPETE_MS 150                 // Depois disso, BOTAO_REPETE a cada intervalo
+
+#if BOTAO_BORDAS & (BOTAO_BORDAS - 1)
+#error "BOTAO_BORDAS deve ser potência de 2"
+#endif
+
+typedef enum {
+    BOTAO_PRESSIONADO,
+    BOTAO_SOLTO,
+    BOTAO_LONGO,                            // Uma vez por pressionamento
+    BOTAO_REPETE                            // Enquanto continuar pressionado após BOTAO_LONGO
+} botao_acao_t;
+
+// Dado de EVENTO_BOTAO: número do botão (1 a BOTOES_MAX) nos 4 bits baixos, ação nos altos
+#define BOTAO_DADO(botao, acao) ((uint8_t)(((acao) << 4) | (botao)))
+
+static inline uint8_t botao_numero(uint8_t dado)
+{
+    return dado & 0x0F;
+}
+
+static inline botao_acao_t botao_acao(uint8_t dado)
+{
+    return (botao_acao_t)(dado >> 4);
+}
+
+int botoes_adiciona(uint gpio);
+bool botao_pressionado(uint8_t botao);
+uint32_t botao_bordas(uint8_t botao);
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include "eventos.h"
+#include "hardware/sync.h"
+
+// Latência de cada tipo de evento: da publicação até o laço principal retirá-lo da fila
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} evento_latencia_t;
+
+static evento_latencia_t latencias[EVENTO_TIPOS];
+
+static const char *const nomes[EVENTO_TIPOS] = {
+  [EVENTO_BOTAO] = "botao",
+  [EVENTO_RX] = "rx",
+  [EVENTO_TIMEOUT] = "timeout",
+  [EVENTO_QUADRO] = "quadro",
+  [EVENTO_TICK] = "tick",
+  [EVENTO_ANIMACAO] = "animacao",
+};
+
+static evento_t fila[EVENTOS_MAX];
+static volatile uint32_t head = 0;          // Próxima escrita
+static volatile uint32_t tail = 0;          // Próxima leitura
+static volatile uint32_t descartados = 0;   // Eventos perdidos com a fila cheia
+static spin_lock_t *trava;                  // Exclusão entre os produtores dos dois núcleos
+
+// Reserva a spin lock da fila. Deve ser chamada antes de qualquer evento_post().
+void evento_init()
+{
+    trava = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+// Publica um evento. Pode ser chamada de qualquer interrupção e de qualquer núcleo: a escrita
+// é feita sob a spin lock, que também desabilita as interrupções do núcleo atual, já que há
+// vários produtores (no MODO_DUAL_CORE as interrupções de DMA do núcleo 1 também publicam).
+// Acorda o laço com __sev().
+bool evento_post(evento_tipo_t tipo, uint8_t dado)
+{
+    bool ok = false;
+    uint32_t status = spin_lock_blocking(trava);
+    if (head - tail < EVENTOS_MAX) {
+        evento_t *ev = &fila[head & (EVENTOS_MAX - 1)];
+        ev->tipo = tipo;
+        ev->dado = dado;
+        ev->instante = time_us_32();
+        head = head + 1;
+        ok = true;
+    } else {
+        descartados = descartados + 1;
+    }
+    spin_unlock(trava, status);
+    __sev();
+    return ok;
+}
+
+// Retira o evento mais antigo, se houver. Só o laço principal consome a fila.
+bool evento_get(evento_t *ev)
+{
+    if (tail == head)
+        return false;
+    __dmb();
+    *ev = fila[tail & (EVENTOS_MAX - 1)];
+    __dmb();
+    tail = tail + 1;
+
+    evento_latencia_t *l = &latencias[ev->tipo];
+    uint32_t us = time_us_32() - ev->instante;
+    if (l->count == 0 || us < l->min)
+        l->min = us;
+    if (us > l->max)
+        l->max = us;
+    l->total += us;
+    l->count++;
+    return true;
+}
+
+// Dorme até haver um evento e o retira da fila. Um __sev() entre a verificação e o
+// __wfe() deixa o registrador de evento setado, então o despertar não se perde.
+void evento_wait(evento_t *ev)
+{
+    while (!evento_get(ev))
+        __wfe();
+}
+
+uint32_t evento_descartados()
+{
+    return descartados;
+}
+
+// Imprime a latência por tipo de evento e quantos foram perdidos com a fila cheia
+void evento_dump()
+{
+    printf("evento         n    min (us)  media (us)    max (us)\r\n");
+    for (int i = 0; i < EVENTO_TIPOS; i++) {
+        const evento_latencia_t *l = &latencias[i];
+        printf("%-10s %5lu %11lu %11lu %11lu\r\n", nomes[i], (unsigned long)l->count, (unsigned long)l->min,
+               (unsigned long)(l->count ? l->total / l->count : 0), (unsigned long)l->max);
+    }
+    printf("eventos descartados (fila cheia): %lu\r\n", (unsigned long)evento_descartados());
+}
@@ -0,0 +1,28 @@
+#include "pico/stdlib.h"
+
+// Fila de eventos entre as interrupções (produtores) e o laço principal (consumidor).
+// O laço dorme em __wfe() até que algum evento seja publicado.
+#define EVENTOS_MAX 32                      // Capacidade da fila; deve ser potência de 2
+
+typedef enum {
+  EVENTO_BOTAO,                             // Mudança de um botão (dado: BOTAO_DADO(), inc/botoes.h)
+  EVENTO_RX,                                // Chegaram caracteres na fila de recepção
+  EVENTO_TIMEOUT,                           // Tempo de inatividade esgotado: voltar à tela padrão
+  EVENTO_QUADRO,                            // Fim do envio de um quadro (dado: 0 = display, 1 = matriz)
+  EVENTO_TICK,                              // Passo de taxa fixa do modo texto
+  EVENTO_ANIMACAO,                          // Próximo quadro da animação da matriz
+  EVENTO_TIPOS
+} evento_tipo_t;
+
+typedef struct {
+  uint8_t tipo;                             // Um dos valores de evento_tipo_t
+  uint8_t dado;                             // Parâmetro do evento
+  uint32_t instante;                        // time_us_32() no momento da publicação
+} evento_t;
+
+void evento_init();
+bool evento_post(evento_tipo_t tipo, uint8_t dado);
+bool evento_get(evento_t *ev);
+void evento_wait(evento_t *ev);
+uint32_t evento_descartados();
+void evento_dump();
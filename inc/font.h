@@ -1,74 +1,134 @@
+// Fontes para A-Z, a-z, 0-9 e demais caracteres ASCII imprimíveis. Os caracteres tem 8x8 pixels
+//
+// Cada glifo é GLIFO(nome, caractere, 8 colunas), na ordem em que fica em font[]. A mesma lista gera
+// os bitmaps, o número de cada glifo (FONT_GLIFO_<nome>) e a tabela font_index, então incluir
+// ou reordenar um glifo não exige renumerar nada à mão.
+#define FONT_GLIFOS(GLIFO) \
+  GLIFO(ESPACO,           ' ',   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(0,                '0',   0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00) \
+  GLIFO(1,                '1',   0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00) \
+  GLIFO(2,                '2',   0x30, 0x49, 0x49, 0x49, 0x49, 0x46, 0x00, 0x00) \
+  GLIFO(3,                '3',   0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00) \
+  GLIFO(4,                '4',   0x3f, 0x20, 0x20, 0x78, 0x20, 0x20, 0x00, 0x00) \
+  GLIFO(5,                '5',   0x4f, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00) \
+  GLIFO(6,                '6',   0x3f, 0x48, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00) \
+  GLIFO(7,                '7',   0x01, 0x01, 0x01, 0x61, 0x31, 0x0d, 0x03, 0x00) \
+  GLIFO(8,                '8',   0x36, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00) \
+  GLIFO(9,                '9',   0x06, 0x09, 0x09, 0x09, 0x09, 0x09, 0x7f, 0x00) \
+  GLIFO(A,                'A',   0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00) \
+  GLIFO(B,                'B',   0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00) \
+  GLIFO(C,                'C',   0x7e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x00) \
+  GLIFO(D,                'D',   0x7f, 0x41, 0x41, 0x41, 0x41, 0x41, 0x7e, 0x00) \
+  GLIFO(E,                'E',   0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00) \
+  GLIFO(F,                'F',   0x7f, 0x09, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00) \
+  GLIFO(G,                'G',   0x7f, 0x41, 0x41, 0x41, 0x51, 0x51, 0x73, 0x00) \
+  GLIFO(H,                'H',   0x7f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7f, 0x00) \
+  GLIFO(I,                'I',   0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(J,                'J',   0x21, 0x41, 0x41, 0x3f, 0x01, 0x01, 0x01, 0x00) \
+  GLIFO(K,                'K',   0x00, 0x7f, 0x08, 0x08, 0x14, 0x22, 0x41, 0x00) \
+  GLIFO(L,                'L',   0x7f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00) \
+  GLIFO(M,                'M',   0x7f, 0x02, 0x04, 0x08, 0x04, 0x02, 0x7f, 0x00) \
+  GLIFO(N,                'N',   0x7f, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7f, 0x00) \
+  GLIFO(O,                'O',   0x3e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00) \
+  GLIFO(P,                'P',   0x7f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00) \
+  GLIFO(Q,                'Q',   0x3e, 0x41, 0x41, 0x49, 0x51, 0x61, 0x7e, 0x00) \
+  GLIFO(R,                'R',   0x7f, 0x11, 0x11, 0x11, 0x31, 0x51, 0x0e, 0x00) \
+  GLIFO(S,                'S',   0x46, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00) \
+  GLIFO(T,                'T',   0x01, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x01, 0x00) \
+  GLIFO(U,                'U',   0x3f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x3f, 0x00) \
+  GLIFO(V,                'V',   0x0f, 0x10, 0x20, 0x40, 0x20, 0x10, 0x0f, 0x00) \
+  GLIFO(W,                'W',   0x7f, 0x20, 0x10, 0x08, 0x10, 0x20, 0x7f, 0x00) \
+  GLIFO(X,                'X',   0x00, 0x41, 0x22, 0x14, 0x14, 0x22, 0x41, 0x00) \
+  GLIFO(Y,                'Y',   0x01, 0x02, 0x04, 0x78, 0x04, 0x02, 0x01, 0x00) \
+  GLIFO(Z,                'Z',   0x41, 0x61, 0x59, 0x45, 0x43, 0x41, 0x00, 0x00) \
+  GLIFO(a,                'a',   0x20, 0x54, 0x54, 0x54, 0x54, 0x78, 0x00, 0x00) \
+  GLIFO(b,                'b',   0x7f, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00, 0x00) \
+  GLIFO(c,                'c',   0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00) \
+  GLIFO(d,                'd',   0x30, 0x48, 0x48, 0x48, 0x48, 0x7f, 0x00, 0x00) \
+  GLIFO(e,                'e',   0x38, 0x54, 0x54, 0x54, 0x54, 0x58, 0x00, 0x00) \
+  GLIFO(f,                'f',   0x08, 0x7e, 0x09, 0x09, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(g,                'g',   0x18, 0xa4, 0xa4, 0xa4, 0xa4, 0x7c, 0x00, 0x00) \
+  GLIFO(h,                'h',   0x7f, 0x08, 0x08, 0x08, 0x08, 0x70, 0x00, 0x00) \
+  GLIFO(i,                'i',   0x00, 0x00, 0x00, 0x7a, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(j,                'j',   0x40, 0x80, 0x80, 0x7a, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(k,                'k',   0x7f, 0x10, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00) \
+  GLIFO(l,                'l',   0x00, 0x00, 0x00, 0x7f, 0x40, 0x00, 0x00, 0x00) \
+  GLIFO(m,                'm',   0x7c, 0x04, 0x04, 0x78, 0x04, 0x04, 0x78, 0x00) \
+  GLIFO(n,                'n',   0x7c, 0x04, 0x04, 0x04, 0x04, 0x78, 0x00, 0x00) \
+  GLIFO(o,                'o',   0x38, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00) \
+  GLIFO(p,                'p',   0xfc, 0x24, 0x24, 0x24, 0x24, 0x18, 0x00, 0x00) \
+  GLIFO(q,                'q',   0x18, 0x24, 0x24, 0x24, 0x24, 0xfc, 0x00, 0x00) \
+  GLIFO(r,                'r',   0x7c, 0x08, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(s,                's',   0x48, 0x54, 0x54, 0x54, 0x54, 0x24, 0x00, 0x00) \
+  GLIFO(t,                't',   0x04, 0x3f, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(u,                'u',   0x3c, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x00, 0x00) \
+  GLIFO(v,                'v',   0x1c, 0x20, 0x40, 0x40, 0x20, 0x1c, 0x00, 0x00) \
+  GLIFO(w,                'w',   0x3c, 0x40, 0x40, 0x30, 0x40, 0x40, 0x3c, 0x00) \
+  GLIFO(x,                'x',   0x44, 0x28, 0x10, 0x10, 0x28, 0x44, 0x00, 0x00) \
+  GLIFO(y,                'y',   0x1c, 0xa0, 0xa0, 0xa0, 0xa0, 0x7c, 0x00, 0x00) \
+  GLIFO(z,                'z',   0x44, 0x64, 0x54, 0x4c, 0x44, 0x00, 0x00, 0x00) \
+  GLIFO(PONTO,            '.',   0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(VIRGULA,          ',',   0x00, 0x50, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(EXCLAMACAO,       '!',   0x00, 0x00, 0x5f, 0x00, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(DOIS_PONTOS,      ':',   0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(ASPAS,            '"',   0x00, 0x00, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00) \
+  GLIFO(CERQUILHA,        '#',   0x00, 0x14, 0x7f, 0x14, 0x7f, 0x14, 0x00, 0x00) \
+  GLIFO(CIFRAO,           '$',   0x00, 0x24, 0x2a, 0x7f, 0x2a, 0x12, 0x00, 0x00) \
+  GLIFO(PORCENTO,         '%',   0x00, 0x23, 0x13, 0x08, 0x64, 0x62, 0x00, 0x00) \
+  GLIFO(E_COMERCIAL,      '&',   0x00, 0x36, 0x49, 0x56, 0x20, 0x50, 0x00, 0x00) \
+  GLIFO(APOSTROFO,        '\'',  0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(ABRE_PARENTESE,   '(',   0x00, 0x00, 0x1c, 0x22, 0x41, 0x00, 0x00, 0x00) \
+  GLIFO(FECHA_PARENTESE,  ')',   0x00, 0x00, 0x41, 0x22, 0x1c, 0x00, 0x00, 0x00) \
+  GLIFO(ASTERISCO,        '*',   0x00, 0x2a, 0x1c, 0x7f, 0x1c, 0x2a, 0x00, 0x00) \
+  GLIFO(MAIS,             '+',   0x00, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x00, 0x00) \
+  GLIFO(MENOS,            '-',   0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00) \
+  GLIFO(BARRA,            '/',   0x00, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00) \
+  GLIFO(PONTO_VIRGULA,    ';',   0x00, 0x00, 0x56, 0x36, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(MENOR,            '<',   0x00, 0x08, 0x14, 0x22, 0x41, 0x00, 0x00, 0x00) \
+  GLIFO(IGUAL,            '=',   0x00, 0x14, 0x14, 0x14, 0x14, 0x14, 0x00, 0x00) \
+  GLIFO(MAIOR,            '>',   0x00, 0x00, 0x41, 0x22, 0x14, 0x08, 0x00, 0x00) \
+  GLIFO(INTERROGACAO,     '?',   0x00, 0x02, 0x01, 0x51, 0x09, 0x06, 0x00, 0x00) \
+  GLIFO(ARROBA,           '@',   0x00, 0x32, 0x49, 0x79, 0x41, 0x3e, 0x00, 0x00) \
+  GLIFO(ABRE_COLCHETE,    '[',   0x00, 0x00, 0x7f, 0x41, 0x41, 0x00, 0x00, 0x00) \
+  GLIFO(BARRA_INVERTIDA,  '\\',  0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x00) \
+  GLIFO(FECHA_COLCHETE,   ']',   0x00, 0x00, 0x41, 0x41, 0x7f, 0x00, 0x00, 0x00) \
+  GLIFO(CIRCUNFLEXO,      '^',   0x00, 0x04, 0x02, 0x01, 0x02, 0x04, 0x00, 0x00) \
+  GLIFO(SUBLINHADO,       '_',   0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00) \
+  GLIFO(CRASE,            '`',   0x00, 0x00, 0x01, 0x02, 0x04, 0x00, 0x00, 0x00) \
+  GLIFO(ABRE_CHAVE,       '{',   0x00, 0x00, 0x08, 0x36, 0x41, 0x00, 0x00, 0x00) \
+  GLIFO(BARRA_VERTICAL,   '|',   0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00) \
+  GLIFO(FECHA_CHAVE,      '}',   0x00, 0x00, 0x41, 0x36, 0x08, 0x00, 0x00, 0x00) \
+  GLIFO(TIL,              '~',   0x00, 0x08, 0x04, 0x08, 0x10, 0x08, 0x00, 0x00)
 
-// Fontes para A-Z, a-z, 0-9 e caracteres especiais. Os caracteres tem 8x8 pixels
+#define FONT_BITMAP(nome, c, ...) __VA_ARGS__,
+static const uint8_t font[] = {
+  FONT_GLIFOS(FONT_BITMAP)
+};
+#undef FONT_BITMAP
+
+#define FONT_NUMERO(nome, c, ...) FONT_GLIFO_##nome,
+enum { FONT_GLIFOS(FONT_NUMERO) FONT_NUM_GLIFOS };
+#undef FONT_NUMERO
 
+_Static_assert(sizeof(font) == FONT_NUM_GLIFOS * 8, "cada glifo deve ter 8 colunas");
 
-static uint8_t font[] = {
-0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
-0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, //0
-0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00, //1
-0x30, 0x49, 0x49, 0x49, 0x49, 0x46, 0x00, 0x00, //2
-0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, //3
-0x3f, 0x20, 0x20, 0x78, 0x20, 0x20, 0x00, 0x00, //4
-0x4f, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, //5
-0x3f, 0x48, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00, //6
-0x01, 0x01, 0x01, 0x61, 0x31, 0x0d, 0x03, 0x00, //7
-0x36, 0x49, 0x49, 0x49, 0x49, 0x49, 0x36, 0x00, //8
-0x06, 0x09, 0x09, 0x09, 0x09, 0x09, 0x7f, 0x00, //9
-0x78, 0x14, 0x12, 0x11, 0x12, 0x14, 0x78, 0x00, //A
-0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x7f, 0x00, //B
-0x7e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x00, //C
-0x7f, 0x41, 0x41, 0x41, 0x41, 0x41, 0x7e, 0x00, //D
-0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00, //E
-0x7f, 0x09, 0x09, 0x09, 0x09, 0x01, 0x01, 0x00, //F
-0x7f, 0x41, 0x41, 0x41, 0x51, 0x51, 0x73, 0x00, //G
-0x7f, 0x08, 0x08, 0x08, 0x08, 0x08, 0x7f, 0x00, //H
-0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, //I
-0x21, 0x41, 0x41, 0x3f, 0x01, 0x01, 0x01, 0x00, //J
-0x00, 0x7f, 0x08, 0x08, 0x14, 0x22, 0x41, 0x00, //K
-0x7f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00, //L
-0x7f, 0x02, 0x04, 0x08, 0x04, 0x02, 0x7f, 0x00, //M
-0x7f, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7f, 0x00, //N
-0x3e, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00, //O
-0x7f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00, //P
-0x3e, 0x41, 0x41, 0x49, 0x51, 0x61, 0x7e, 0x00, //Q
-0x7f, 0x11, 0x11, 0x11, 0x31, 0x51, 0x0e, 0x00, //R
-0x46, 0x49, 0x49, 0x49, 0x49, 0x30, 0x00, 0x00, //S
-0x01, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x01, 0x00, //T
-0x3f, 0x40, 0x40, 0x40, 0x40, 0x40, 0x3f, 0x00, //U
-0x0f, 0x10, 0x20, 0x40, 0x20, 0x10, 0x0f, 0x00, //V
-0x7f, 0x20, 0x10, 0x08, 0x10, 0x20, 0x7f, 0x00, //W
-0x00, 0x41, 0x22, 0x14, 0x14, 0x22, 0x41, 0x00, //X
-0x01, 0x02, 0x04, 0x78, 0x04, 0x02, 0x01, 0x00, //Y
-0x41, 0x61, 0x59, 0x45, 0x43, 0x41, 0x00, 0x00, //Z
-0x20, 0x54, 0x54, 0x54, 0x54, 0x78, 0x00, 0x00, // a
-0x7f, 0x48, 0x48, 0x48, 0x48, 0x30, 0x00, 0x00, // b
-0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, // c
-0x30, 0x48, 0x48, 0x48, 0x48, 0x7f, 0x00, 0x00, // d
-0x38, 0x54, 0x54, 0x54, 0x54, 0x58, 0x00, 0x00, // e
-0x08, 0x7e, 0x09, 0x09, 0x00, 0x00, 0x00, 0x00, // f
-0x18, 0xa4, 0xa4, 0xa4, 0xa4, 0x7c, 0x00, 0x00, // g
-0x7f, 0x08, 0x08, 0x08, 0x08, 0x70, 0x00, 0x00, // h
-0x00, 0x00, 0x00, 0x7a, 0x00, 0x00, 0x00, 0x00, // i
-0x40, 0x80, 0x80, 0x7a, 0x00, 0x00, 0x00, 0x00, // j
-0x7f, 0x10, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, // k
-0x00, 0x00, 0x00, 0x7f, 0x40, 0x00, 0x00, 0x00, // l
-0x7c, 0x04, 0x04, 0x78, 0x04, 0x04, 0x78, 0x00, // m
-0x7c, 0x04, 0x04, 0x04, 0x04, 0x78, 0x00, 0x00, // n
-0x38, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00, // o
-0xfc, 0x24, 0x24, 0x24, 0x24, 0x18, 0x00, 0x00, // p
-0x18, 0x24, 0x24, 0x24, 0x24, 0xfc, 0x00, 0x00, // q
-0x7c, 0x08, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, // r
-0x48, 0x54, 0x54, 0x54, 0x54, 0x24, 0x00, 0x00, // s
-0x04, 0x3f, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, // t
-0x3c, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x00, 0x00, // u
-0x1c, 0x20, 0x40, 0x40, 0x20, 0x1c, 0x00, 0x00, // v
-0x3c, 0x40, 0x40, 0x30, 0x40, 0x40, 0x3c, 0x00, // w
-0x44, 0x28, 0x10, 0x10, 0x28, 0x44, 0x00, 0x00, // x
-0x1c, 0xa0, 0xa0, 0xa0, 0xa0, 0x7c, 0x00, 0x00, // y
-0x44, 0x64, 0x54, 0x4c, 0x44, 0x00, 0x00, 0x00, // z
-0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, // .
-0x00, 0x50, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, // ,
-0x00, 0x00, 0x5f, 0x00, 0x00, 0x00, 0x00, 0x00, // !
-0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, // :
+// Glifo usado para bytes sem representação na fonte (0 = espaço)
+#ifndef FONT_FALLBACK_GLYPH
+#define FONT_FALLBACK_GLYPH 0
+#endif
 
+// Número do glifo de cada byte em font[] (deslocamento = número * 8). Todo o ASCII
+// imprimível tem entrada própria; os demais bytes caem em FONT_FALLBACK_GLYPH. As entradas
+// dos glifos sobrescrevem o preenchimento de propósito, então -Woverride-init é desligado
+// só aqui.
+#define FONT_INDICE(nome, c, ...) [(uint8_t)(c)] = FONT_GLIFO_##nome,
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+static const uint8_t font_index[256] = {
+  [0 ... 255] = FONT_FALLBACK_GLYPH,
+  FONT_GLIFOS(FONT_INDICE)
 };
+#pragma GCC diagnostic pop
+#undef FONT_INDICE
+
+_Static_assert(FONT_FALLBACK_GLYPH < FONT_NUM_GLIFOS, "FONT_FALLBACK_GLYPH fora de font[]");
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <string.h>
+#include "matriz.h"
+#include "matriz_font.h"
+#include "matriz_gamma.h"
+#include "perf.h"
+#include "hardware/dma.h"
+#include "ws2818b.pio.h"                    // Programa para controle de LEDs WS2812B
+
+#define NP_WORD_US 30                       // Tempo de um LED no fio: 24 bits a 800 kHz
+#define NP_RESET_US 60                      // Nível baixo que trava o quadro nos LEDs (mínimo de 50 us)
+
+static npLED_t leds[LED_COUNT];             // Quadro em composição (buffer de trás)
+static npLED_t leds_front[LED_COUNT];       // Quadro sendo enviado pelo DMA (buffer da frente)
+static bool leds_front_valid = false;       // leds_front reflete o que os LEDs exibem
+static PIO np_pio;                          // Variável para referenciar a instância PIO usada
+static uint sm;                             // Variável para armazenar o número do state machine usado
+static uint np_dma;                         // Canal DMA que alimenta a FIFO do state machine
+static volatile uint64_t np_ready_at = 0;   // Instante em que o quadro atual termina de ser travado
+static np_callback_t np_callback = NULL;    // Chamado (em IRQ) ao fim do quadro, após o reset
+static void *np_callback_data = NULL;
+static np_stats_t np_stats;
+
+// Cores pedidas (antes da correção), para reaplicar a tabela quando o brilho mudar, e a
+// tabela combinada gama x brilho usada ao montar as palavras dos LEDs
+static uint8_t np_rgb[LED_COUNT][3];
+static uint8_t np_lut[256];
+static uint8_t np_brightness;
+
+// Posição na fita de cada pixel (x, y), com x da esquerda para a direita e y de cima para
+// baixo. Preenchida uma vez em npInit(); no desenho cada pixel custa só uma leitura.
+static uint16_t np_map[MATRIZ_HEIGHT][MATRIZ_WIDTH];
+
+static void npMapInit()
+{
+    for (uint y = 0; y < MATRIZ_HEIGHT; y++) {
+        for (uint x = 0; x < MATRIZ_WIDTH; x++) {
+            // Rotação: posição física do pixel lógico (x, y)
+            uint px = x, py = y;
+#if MATRIZ_ROTATION == 90
+            px = MATRIZ_WIDTH - 1 - y; py = x;
+#elif MATRIZ_ROTATION == 180
+            px = MATRIZ_WIDTH - 1 - x; py = MATRIZ_HEIGHT - 1 - y;
+#elif MATRIZ_ROTATION == 270
+            px = y; py = MATRIZ_HEIGHT - 1 - x;
+#endif
+            // Coluna e linha contadas a partir do canto onde a fita começa
+            uint col = (MATRIZ_ORIGIN == MATRIZ_ORIGIN_TOP_RIGHT || MATRIZ_ORIGIN == MATRIZ_ORIGIN_BOTTOM_RIGHT)
+                       ? MATRIZ_WIDTH - 1 - px : px;
+            uint row = (MATRIZ_ORIGIN == MATRIZ_ORIGIN_BOTTOM_LEFT || MATRIZ_ORIGIN == MATRIZ_ORIGIN_BOTTOM_RIGHT)
+                       ? MATRIZ_HEIGHT - 1 - py : py;
+            if (MATRIZ_SERPENTINE && (row & 1))
+                col = MATRIZ_WIDTH - 1 - col;
+            np_map[y][x] = row * MATRIZ_WIDTH + col;
+        }
+    }
+}
+
+// Função para inicializar o PIO para controle dos LEDs
+void npInit(uint pin) 
+{
+    uint offset = pio_add_program(pio0, &ws2818b_program);      // Carregar o programa PIO
+    np_pio = pio0;                                              // Usar o primeiro bloco PIO
+
+    int livre = pio_claim_unused_sm(np_pio, false);             // Tentar usar uma state machine do pio0
+    if (livre < 0)                                              // Se não houver disponível no pio0
+    {
+        np_pio = pio1;                                          // Mudar para o pio1
+        offset = pio_add_program(np_pio, &ws2818b_program);     // Carregar o programa também no pio1
+        livre = pio_claim_unused_sm(np_pio, true);              // Usar uma state machine do pio1
+    }
+    sm = (uint)livre;
+
+    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);    // Inicializar state machine para LEDs
+
+    // O DMA entrega uma palavra por LED, no ritmo do DREQ da FIFO de transmissão
+    np_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(np_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, sm, true));
+    dma_channel_configure(np_dma, &c, &np_pio->txf[sm], leds_front, LED_COUNT, false);
+
+    npMapInit();                                                // Montar a tabela de posições da fita
+    npSetBrightness(NP_BRILHO_PADRAO);                          // Monta a tabela de cores
+    npClear();                                                  // Inicializar todos os LEDs como apagados
+}
+
+// Função para definir a cor de um LED específico. A cor passa pela tabela de gama e brilho
+// aqui, ao montar a palavra, e não em cada chamador.
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) 
+{
+    np_rgb[index][0] = r;
+    np_rgb[index][1] = g;
+    np_rgb[index][2] = b;
+    leds[index] = ((uint32_t)np_lut[g] << 24) | ((uint32_t)np_lut[r] << 16) | ((uint32_t)np_lut[b] << 8);
+}
+
+// Ajusta o brilho global: refaz a tabela combinada (só aqui, nunca por quadro) e reaplica
+// às cores do quadro em composição. O novo brilho aparece no próximo npWrite().
+void npSetBrightness(uint8_t brightness)
+{
+    np_brightness = brightness;
+    for (uint i = 0; i < 256; i++)
+        np_lut[i] = (matriz_gamma[i] * brightness + 127) / 255;
+    for (uint i = 0; i < LED_COUNT; i++)
+        npSetLED(i, np_rgb[i][0], np_rgb[i][1], np_rgb[i][2]);
+}
+
+uint8_t npGetBrightness()
+{
+    return np_brightness;
+}
+
+// Função para definir a cor do pixel (x, y) da matriz
+void npSetPixel(uint x, uint y, const uint8_t r, const uint8_t g, const uint8_t b)
+{
+    npSetLED(np_map[y][x], r, g, b);
+}
+
+// Função para limpar (apagar) todos os LEDs
+void npClear() 
+{
+    for (uint i = 0; i < LED_COUNT; ++i)                        // Iterar sobre todos os LEDs
+        leds[i] = 0;                                            // Definir cor como preta (apagado)
+    memset(np_rgb, 0, sizeof(np_rgb));
+}
+
+// Glifo de c no formato de matriz_font. Minúsculas usam o glifo da maiúscula; caracteres
+// sem glifo resultam em 0.
+uint32_t npGlyph(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        c -= 'a' - 'A';
+    return (uint8_t)c < count_of(matriz_font) ? matriz_font[(uint8_t)c] : 0;
+}
+
+// Desenha o glifo de c no canto superior esquerdo com a cor dada, apagando o restante da
+// matriz. Caracteres sem glifo apagam a matriz.
+
+void npDrawGlyph(char c, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint32_t glyph = npGlyph(c);
+
+    npClear();
+    for (uint y = 0; y < 5 && y < MATRIZ_HEIGHT; y++) {
+        for (uint x = 0; x < 5 && x < MATRIZ_WIDTH; x++) {
+            if (glyph & (1u << (5 * y + 4 - x)))
+                npSetPixel(x, y, r, g, b);
+        }
+    }
+}
+
+// Coluna x (0 = esquerda) do glifo de c, com a linha y no bit y. Caracteres sem glifo
+// resultam em coluna vazia.
+uint8_t npGlyphColumn(char c, uint x)
+{
+    uint32_t glyph = npGlyph(c);
+    uint8_t column = 0;
+    for (uint y = 0; y < 5 && x < 5; y++) {
+        if (glyph & (1u << (5 * y + 4 - x)))
+            column |= 1u << y;
+    }
+    return column;
+}
+
+// Acende os pixels da coluna x indicados em bits (linha y no bit y) e apaga os demais
+void npSetColumn(uint x, uint8_t bits, uint8_t r, uint8_t g, uint8_t b)
+{
+    for (uint y = 0; y < MATRIZ_HEIGHT; y++) {
+        if (bits & (1u << y))
+            npSetPixel(x, y, r, g, b);
+        else
+            npSetPixel(x, y, 0, 0, 0);
+    }
+}
+
+static int64_t np_latch_callback(alarm_id_t id, void *user_data)
+{
+    if (np_callback)
+        np_callback(np_callback_data);
+    return 0;
+}
+
+// Função para atualizar os LEDs no hardware. Copia o quadro para o buffer da frente e
+// retorna logo após disparar o DMA; leds[] pode ser alterado em seguida. Se o quadro
+// anterior ainda estiver sendo enviado (ou travado), espera por ele primeiro. Um quadro
+// igual ao último enviado não é transmitido, e o callback de fim de quadro não é chamado.
+void npWrite() 
+{
+    PERF_BEGIN(PERF_NP_WRITE);
+    // leds_front só muda aqui, então pode ser comparado mesmo com o DMA em andamento
+    if (leds_front_valid && memcmp(leds_front, leds, sizeof(leds)) == 0) {
+        np_stats.skipped++;
+        PERF_END(PERF_NP_WRITE);
+        return;
+    }
+    while (npBusy())
+        tight_loop_contents();
+
+    memcpy(leds_front, leds, sizeof(leds));
+    leds_front_valid = true;
+    // O PIO consome as palavras a uma taxa fixa, então o fim do quadro é conhecido no disparo
+    np_ready_at = time_us_64() + LED_COUNT * NP_WORD_US + NP_RESET_US;
+    dma_channel_transfer_from_buffer_now(np_dma, leds_front, LED_COUNT);
+    np_stats.frames++;
+    np_stats.words += LED_COUNT;
+    add_alarm_in_us(LED_COUNT * NP_WORD_US + NP_RESET_US, np_latch_callback, NULL, true);
+    PERF_END(PERF_NP_WRITE);
+}
+
+// Verdadeiro enquanto o quadro estiver no DMA, no fio ou no intervalo de reset.
+// Não depende de interrupções, então pode ser consultada em qualquer contexto.
+bool npBusy()
+{
+    return dma_channel_is_busy(np_dma) || time_us_64() < np_ready_at;
+}
+
+void npSetCallback(np_callback_t callback, void *user_data)
+{
+    np_callback = callback;
+    np_callback_data = user_data;
+}
+
+np_stats_t npGetStats()
+{
+    return np_stats;
+}
+
+// Imprime o quadro em composição no stdout como PPM ASCII (P3), em coordenadas da matriz,
+// com os valores já corrigidos (gama e brilho) que vão para os LEDs
+void npDumpPPM()
+{
+    printf("P3\n%u %u\n255\n", MATRIZ_WIDTH, MATRIZ_HEIGHT);
+    for (uint y = 0; y < MATRIZ_HEIGHT; y++) {
+        for (uint x = 0; x < MATRIZ_WIDTH; x++) {
+            npLED_t led = leds[np_map[y][x]];
+            printf("%u %u %u ", (unsigned)(led >> 16) & 0xFF, (unsigned)(led >> 24), (unsigned)(led >> 8) & 0xFF);
+        }
+        putchar('\n');
+    }
+}
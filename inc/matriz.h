@@ -0,0 +1,65 @@
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Geometria e ligação da matriz. O padrão corresponde à placa: 5x5, primeiro LED no canto
+// inferior direito, linhas em zigue-zague (serpentina) e sem rotação.
+#ifndef MATRIZ_WIDTH
+#define MATRIZ_WIDTH 5                      // Colunas da matriz
+#endif
+#ifndef MATRIZ_HEIGHT
+#define MATRIZ_HEIGHT 5                     // Linhas da matriz
+#endif
+
+#define MATRIZ_ORIGIN_TOP_LEFT 0
+#define MATRIZ_ORIGIN_TOP_RIGHT 1
+#define MATRIZ_ORIGIN_BOTTOM_LEFT 2
+#define MATRIZ_ORIGIN_BOTTOM_RIGHT 3
+#ifndef MATRIZ_ORIGIN
+#define MATRIZ_ORIGIN MATRIZ_ORIGIN_BOTTOM_RIGHT    // Canto onde a fita começa
+#endif
+#ifndef MATRIZ_SERPENTINE
+#define MATRIZ_SERPENTINE 1                 // 1: linhas alternam o sentido; 0: todas no mesmo sentido
+#endif
+#ifndef MATRIZ_ROTATION
+#define MATRIZ_ROTATION 0                   // Rotação da imagem em graus (0, 90, 180 ou 270), sentido horário
+#endif
+
+#ifndef NP_BRILHO_PADRAO
+#define NP_BRILHO_PADRAO 55                 // Brilho global inicial (0 a 255), aplicado após a gama
+#endif
+
+#if (MATRIZ_ROTATION % 180) && (MATRIZ_WIDTH != MATRIZ_HEIGHT)
+#error "Rotação de 90/270 graus exige matriz quadrada"
+#endif
+
+#define LED_COUNT (MATRIZ_WIDTH * MATRIZ_HEIGHT)    // Número de LEDs na matriz
+
+// Cada LED já guarda a palavra enviada ao PIO: G[31:24] R[23:16] B[15:8].
+// O programa ws2818b consome 24 bits por palavra (autopull), ou seja, um LED por push.
+typedef uint32_t npLED_t;
+
+typedef void (*np_callback_t)(void *user_data);
+
+// Quadros e palavras entregues à FIFO do PIO desde npInit(), e quadros não enviados
+// por serem iguais ao que os LEDs já mostravam
+typedef struct {
+    uint32_t frames;
+    uint32_t words;
+    uint32_t skipped;
+} np_stats_t;
+
+void npInit(uint pin);
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
+void npSetPixel(uint x, uint y, const uint8_t r, const uint8_t g, const uint8_t b);
+void npClear();
+void npWrite();
+uint32_t npGlyph(char c);
+void npDrawGlyph(char c, uint8_t r, uint8_t g, uint8_t b);
+uint8_t npGlyphColumn(char c, uint x);
+void npSetColumn(uint x, uint8_t bits, uint8_t r, uint8_t g, uint8_t b);
+bool npBusy();
+void npSetCallback(np_callback_t callback, void *user_data);
+np_stats_t npGetStats();
+void npDumpPPM();
+void npSetBrightness(uint8_t brightness);
+uint8_t npGetBrightness();
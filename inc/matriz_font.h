@@ -0,0 +1,45 @@
+// Glifos 5x5 para a matriz de LEDs. Cada glifo ocupa 25 bits de um uint32_t: a linha y
+// fica nos bits [5y + 4 : 5y] e, dentro da linha, o bit mais significativo é a coluna 0
+// (esquerda). A tabela é indexada diretamente pelo caractere; entradas ausentes valem 0.
+
+#define MATRIZ_GLYPH(l0, l1, l2, l3, l4) \
+  ((uint32_t)(l0) | ((uint32_t)(l1) << 5) | ((uint32_t)(l2) << 10) | ((uint32_t)(l3) << 15) | ((uint32_t)(l4) << 20))
+
+static const uint32_t matriz_font[128] = {
+  ['0'] = MATRIZ_GLYPH(0b01110, 0b01010, 0b01010, 0b01010, 0b01110),
+  ['1'] = MATRIZ_GLYPH(0b00100, 0b00100, 0b00100, 0b00100, 0b00100),
+  ['2'] = MATRIZ_GLYPH(0b01110, 0b00010, 0b01110, 0b01000, 0b01110),
+  ['3'] = MATRIZ_GLYPH(0b01110, 0b00010, 0b01110, 0b00010, 0b01110),
+  ['4'] = MATRIZ_GLYPH(0b01010, 0b01010, 0b01110, 0b00010, 0b00010),
+  ['5'] = MATRIZ_GLYPH(0b01110, 0b01000, 0b01110, 0b00010, 0b01110),
+  ['6'] = MATRIZ_GLYPH(0b01110, 0b01000, 0b01110, 0b01010, 0b01110),
+  ['7'] = MATRIZ_GLYPH(0b01110, 0b00010, 0b00010, 0b00010, 0b00010),
+  ['8'] = MATRIZ_GLYPH(0b01110, 0b01010, 0b01110, 0b01010, 0b01110),
+  ['9'] = MATRIZ_GLYPH(0b01110, 0b01010, 0b01110, 0b00010, 0b01110),
+  ['A'] = MATRIZ_GLYPH(0b01110, 0b01010, 0b01110, 0b01010, 0b01010),
+  ['B'] = MATRIZ_GLYPH(0b01100, 0b01010, 0b01100, 0b01010, 0b01100),
+  ['C'] = MATRIZ_GLYPH(0b01110, 0b01000, 0b01000, 0b01000, 0b01110),
+  ['D'] = MATRIZ_GLYPH(0b01100, 0b01010, 0b01010, 0b01010, 0b01100),
+  ['E'] = MATRIZ_GLYPH(0b01110, 0b01000, 0b01110, 0b01000, 0b01110),
+  ['F'] = MATRIZ_GLYPH(0b01110, 0b01000, 0b01110, 0b01000, 0b01000),
+  ['G'] = MATRIZ_GLYPH(0b01110, 0b10000, 0b10110, 0b10010, 0b01110),
+  ['H'] = MATRIZ_GLYPH(0b01010, 0b01010, 0b01110, 0b01010, 0b01010),
+  ['I'] = MATRIZ_GLYPH(0b01110, 0b00100, 0b00100, 0b00100, 0b01110),
+  ['J'] = MATRIZ_GLYPH(0b01110, 0b00010, 0b00010, 0b01010, 0b00100),
+  ['K'] = MATRIZ_GLYPH(0b01001, 0b01010, 0b01100, 0b01010, 0b01010),
+  ['L'] = MATRIZ_GLYPH(0b01000, 0b01000, 0b01000, 0b01000, 0b01110),
+  ['M'] = MATRIZ_GLYPH(0b10001, 0b11011, 0b10101, 0b10001, 0b10001),
+  ['N'] = MATRIZ_GLYPH(0b10001, 0b11001, 0b10101, 0b10011, 0b10001),
+  ['O'] = MATRIZ_GLYPH(0b00100, 0b01010, 0b01010, 0b01010, 0b00100),
+  ['P'] = MATRIZ_GLYPH(0b01100, 0b01010, 0b01100, 0b01000, 0b01000),
+  ['Q'] = MATRIZ_GLYPH(0b00100, 0b01010, 0b01010, 0b01010, 0b00111),
+  ['R'] = MATRIZ_GLYPH(0b01100, 0b01010, 0b01100, 0b01010, 0b01010),
+  ['S'] = MATRIZ_GLYPH(0b00110, 0b01000, 0b00100, 0b00010, 0b01100),
+  ['T'] = MATRIZ_GLYPH(0b11111, 0b00100, 0b00100, 0b00100, 0b00100),
+  ['U'] = MATRIZ_GLYPH(0b01010, 0b01010, 0b01010, 0b01010, 0b01110),
+  ['V'] = MATRIZ_GLYPH(0b01010, 0b01010, 0b01010, 0b01010, 0b00100),
+  ['W'] = MATRIZ_GLYPH(0b10001, 0b10001, 0b10101, 0b10101, 0b11011),
+  ['X'] = MATRIZ_GLYPH(0b10001, 0b01010, 0b00100, 0b01010, 0b10001),
+  ['Y'] = MATRIZ_GLYPH(0b10001, 0b01010, 0b00100, 0b00100, 0b00100),
+  ['Z'] = MATRIZ_GLYPH(0b11111, 0b00010, 0b00100, 0b01000, 0b11111),
+};
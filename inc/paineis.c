@@ -0,0 +1,69 @@
+#include "paineis.h"
+#include "ssd1306.h"
+
+void paineis_init(paineis_t *pn) {
+  pn->total = 0;
+  for (uint b = 0; b < NUM_I2CS; ++b)
+    pn->proximo[b] = 0;
+}
+
+// Registra um painel já inicializado e configurado. Dois painéis com o mesmo endereço no
+// mesmo barramento não podem ser distinguidos e são recusados.
+bool paineis_adiciona(paineis_t *pn, ssd1306_t *ssd) {
+  if (pn->total == PAINEIS_MAX)
+    return false;
+  for (uint8_t i = 0; i < pn->total; ++i)
+    if (pn->painel[i]->i2c_port == ssd->i2c_port && pn->painel[i]->address == ssd->address)
+      return false;
+  pn->painel[pn->total++] = ssd;
+  return true;
+}
+
+static bool paineis_barramento_ocupado(paineis_t *pn, uint barramento) {
+  for (uint8_t i = 0; i < pn->total; ++i)
+    if (i2c_get_index(pn->painel[i]->i2c_port) == barramento && ssd1306_busy(pn->painel[i]))
+      return true;
+  return false;
+}
+
+// Em cada barramento livre, inicia o envio assíncrono do primeiro painel com alterações
+// depois do último atendido. Painéis marcados mas iguais ao que já exibem são descartados
+// pelo driver sem ocupar o barramento, e o rodízio segue para o próximo. Não bloqueia;
+// retorna quantos envios foram iniciados.
+uint paineis_atualiza(paineis_t *pn) {
+  uint iniciados = 0;
+  for (uint b = 0; b < NUM_I2CS; ++b) {
+    if (paineis_barramento_ocupado(pn, b))
+      continue;
+    for (uint8_t k = 0; k < pn->total; ++k) {
+      uint8_t i = (pn->proximo[b] + k) % pn->total;
+      ssd1306_t *ssd = pn->painel[i];
+      if (i2c_get_index(ssd->i2c_port) != b || !ssd1306_dirty(ssd))
+        continue;
+      uint32_t antes = ssd->stats.transactions;
+      ssd1306_send_data_async(ssd);
+      pn->proximo[b] = (i + 1) % pn->total;
+      if (ssd->stats.transactions != antes) {
+        iniciados++;
+        break;
+      }
+    }
+  }
+  return iniciados;
+}
+
+// Verdadeiro enquanto algum painel tiver alterações ou algum envio estiver em andamento
+bool paineis_pendentes(paineis_t *pn) {
+  for (uint8_t i = 0; i < pn->total; ++i)
+    if (ssd1306_dirty(pn->painel[i]) || ssd1306_busy(pn->painel[i]))
+      return true;
+  return false;
+}
+
+// Envia todas as alterações e espera o fim das transmissões
+void paineis_envia(paineis_t *pn) {
+  while (paineis_pendentes(pn)) {
+    if (!paineis_atualiza(pn))
+      tight_loop_contents();
+  }
+}
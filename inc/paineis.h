@@ -0,0 +1,28 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Vários displays SSD1306 (128x64 ou 128x32, endereços 0x3C/0x3D) em um ou nos dois
+// controladores I2C. Cada controlador transmite um painel por vez via DMA, e os dois
+// controladores trabalham em paralelo: paineis_atualiza() inicia, em cada barramento livre,
+// o envio do próximo painel com alterações, em rodízio, e retorna sem esperar. Assim o
+// tempo para atualizar tudo cresce com os painéis por barramento, não com o total.
+//
+//   ssd1306_init(&a, 128, 64, false, 0x3C, i2c0); ssd1306_config(&a); paineis_adiciona(&pn, &a);
+//   ssd1306_init(&b, 128, 32, false, 0x3C, i2c1); ssd1306_config(&b); paineis_adiciona(&pn, &b);
+//   ... desenha em a e b ...
+//   paineis_envia(&pn);
+#define PAINEIS_MAX 8                       // Painéis por gerenciador (4 endereços x 2 barramentos)
+
+typedef struct ssd1306_t ssd1306_t;
+
+typedef struct {
+  ssd1306_t *painel[PAINEIS_MAX];
+  uint8_t total;
+  uint8_t proximo[NUM_I2CS];                // Onde o rodízio de cada barramento continua
+} paineis_t;
+
+void paineis_init(paineis_t *pn);
+bool paineis_adiciona(paineis_t *pn, ssd1306_t *ssd);
+uint paineis_atualiza(paineis_t *pn);
+bool paineis_pendentes(paineis_t *pn);
+void paineis_envia(paineis_t *pn);
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include "perf.h"
+
+#if PERF_ENABLED
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+} perf_stats_t;
+
+static perf_stats_t tabela[PERF_ETAPAS];
+
+static const char *const nomes[PERF_ETAPAS] = {
+  [PERF_SEND_DATA] = "send_data",
+  [PERF_FLUSH] = "flush",
+  [PERF_SEND_ASYNC] = "send_async",
+  [PERF_FILL] = "fill",
+  [PERF_DRAW_STRING] = "draw_string",
+  [PERF_NP_WRITE] = "npWrite",
+  [PERF_RENDER] = "render",
+  [PERF_ENTRADA] = "entrada",
+};
+
+// Lê o contador decrescente de 24 bits do SysTick (um por núcleo)
+uint32_t perf_ciclos()
+{
+  return systick_hw->cvr;
+}
+
+void perf_registra(perf_etapa_t etapa, uint32_t ciclos)
+{
+  perf_stats_t *s = &tabela[etapa];
+  if (s->count == 0 || ciclos < s->min)
+    s->min = ciclos;
+  if (ciclos > s->max)
+    s->max = ciclos;
+  s->total += ciclos;
+  s->count++;
+}
+
+// Liga o SysTick do núcleo que a chama com o relógio do processador e recarga máxima.
+// Trechos com mais de 2^24 ciclos (~134 ms a 125 MHz) não são medidos corretamente.
+void perf_init()
+{
+  systick_hw->csr = 0;
+  systick_hw->rvr = 0xFFFFFF;
+  systick_hw->cvr = 0;
+  systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+void perf_dump()
+{
+  uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+  printf("etapa          n       min      media       max  (ciclos) | media (us)\r\n");
+  for (int i = 0; i < PERF_ETAPAS; i++) {
+    const perf_stats_t *s = &tabela[i];
+    uint32_t media = s->count ? (uint32_t)(s->total / s->count) : 0;
+    printf("%-12s %7lu %9lu %10lu %9lu            | %lu\r\n", nomes[i], (unsigned long)s->count,
+           (unsigned long)s->min, (unsigned long)media, (unsigned long)s->max,
+           (unsigned long)(media / mhz));
+  }
+}
+#else
+void perf_init()
+{
+}
+
+void perf_dump()
+{
+  printf("Instrumentacao desligada (PERF_ENABLED 0)\r\n");
+}
+#endif
@@ -0,0 +1,37 @@
+#include "pico/stdlib.h"
+
+// Instrumentação das etapas quentes: PERF_BEGIN/PERF_END medem em ciclos (SysTick) o trecho
+// entre eles e acumulam mínimo, média, máximo e contagem por etapa; perf_dump() imprime a
+// tabela. Com PERF_ENABLED 0 (padrão) as macros não geram código. Para ligar, defina
+// PERF_ENABLED=1 para todo o alvo (ex.: target_compile_definitions no CMakeLists.txt).
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 0
+#endif
+
+typedef enum {
+  PERF_SEND_DATA,                           // ssd1306_send_data: quadro inteiro, bloqueante
+  PERF_FLUSH,                               // ssd1306_flush: só as regiões alteradas
+  PERF_SEND_ASYNC,                          // ssd1306_send_data_async: cópia para o DMA e disparo
+  PERF_FILL,                                // ssd1306_fill
+  PERF_DRAW_STRING,                         // ssd1306_draw_string(_mode)
+  PERF_NP_WRITE,                            // npWrite: espera do quadro anterior e disparo do DMA
+  PERF_RENDER,                              // Um comando de desenho completo (display e matriz)
+  PERF_ENTRADA,                             // Tratamento de um lote de caracteres recebidos
+  PERF_ETAPAS
+} perf_etapa_t;
+
+#if PERF_ENABLED
+// Cada etapa deve ser medida sempre no mesmo núcleo: o SysTick e a tabela não são
+// compartilhados com segurança entre os dois.
+#define PERF_BEGIN(etapa) uint32_t perf_inicio_##etapa = perf_ciclos()
+#define PERF_END(etapa) perf_registra(etapa, (perf_inicio_##etapa - perf_ciclos()) & 0xFFFFFF)
+
+uint32_t perf_ciclos();
+void perf_registra(perf_etapa_t etapa, uint32_t ciclos);
+#else
+#define PERF_BEGIN(etapa) do {} while (0)
+#define PERF_END(etapa) do {} while (0)
+#endif
+
+void perf_init();
+void perf_dump();
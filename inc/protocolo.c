@@ -0,0 +1,153 @@
+#include "matriz.h"                         // LED_COUNT, para o tamanho da mensagem da matriz
+#include "protocolo.h"
+
+#if PROTO_TAMANHO_MATRIZ > PROTO_MAX_DADOS
+#error "Mensagem da matriz maior que PROTO_MAX_DADOS"
+#endif
+
+typedef enum {
+  ESPERA_SYNC,
+  ESPERA_TIPO,
+  ESPERA_TAMANHO_0,
+  ESPERA_TAMANHO_1,
+  ESPERA_DADOS,
+  ESPERA_CRC_0,
+  ESPERA_CRC_1
+} estado_t;
+
+static estado_t estado = ESPERA_SYNC;
+static uint8_t tipo;
+static uint16_t tamanho, recebidos, crc, crc_recebido;
+static uint8_t cabecalho[PROTO_CABECALHO]; // Bytes retidos até o cabeçalho ser aceito (+ o atual)
+static uint8_t retidos;
+static uint32_t ultimo_byte;
+static uint32_t erros = 0;
+static uint8_t dados[PROTO_MAX_DADOS + 1];
+
+// CRC-16/CCITT-FALSE processado por nibble: tabela de 16 entradas em vez de 256
+static const uint16_t crc_nibble[16] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static inline uint16_t crc16(uint16_t crc, uint8_t byte)
+{
+  crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (byte >> 4)];
+  crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (byte & 0x0F)];
+  return crc;
+}
+
+// Tamanhos possíveis para cada tipo, conferidos assim que o cabeçalho chega
+static bool cabecalho_valido(uint8_t tipo, uint16_t tamanho)
+{
+  switch (tipo) {
+    case PROTO_MATRIZ:
+      return tamanho == PROTO_TAMANHO_MATRIZ;
+    case PROTO_BLIT:
+      return tamanho >= 4 && tamanho <= PROTO_MAX_DADOS;
+    case PROTO_TEXTO:
+      return tamanho >= 2 && tamanho <= PROTO_MAX_DADOS;
+    case PROTO_TIMEOUT:
+      return tamanho == 4;
+    case PROTO_BRILHO:
+      return tamanho == 1;
+    default:
+      return false;
+  }
+}
+
+// Abandona o cabeçalho em andamento e entrega os bytes retidos (e o atual) a quem chamou
+static proto_resultado_t devolve(uint8_t byte, proto_msg_t *msg)
+{
+  cabecalho[retidos++] = byte;
+  estado = ESPERA_SYNC;
+  msg->tipo = 0;
+  msg->tamanho = retidos;
+  msg->dados = cabecalho;
+  return PROTO_DEVOLVE;
+}
+
+// Alimenta o analisador com um byte recebido. Um quadro interrompido por mais de
+// PROTO_TIMEOUT_US é abandonado: se ainda estava no cabeçalho, os bytes retidos são
+// devolvidos junto com o atual; se já estava nos dados, conta um erro e retorna PROTO_ERRO
+// (para o NAK) com o byte atual em msg->dados, que quem chamou analisa de novo desde o início.
+proto_resultado_t protocolo_byte(uint8_t byte, proto_msg_t *msg)
+{
+  uint32_t agora = time_us_32();
+  bool expirou = estado != ESPERA_SYNC && agora - ultimo_byte > PROTO_TIMEOUT_US;
+  ultimo_byte = agora;
+  if (expirou && estado <= ESPERA_TAMANHO_1)
+    return devolve(byte, msg);
+  if (expirou) {
+    estado = ESPERA_SYNC;
+    erros++;
+    cabecalho[0] = byte;
+    msg->tipo = 0;
+    msg->tamanho = 1;
+    msg->dados = cabecalho;
+    return PROTO_ERRO;
+  }
+
+  switch (estado) {
+    case ESPERA_SYNC:
+      if (byte != PROTO_SYNC)
+        return PROTO_LIVRE;
+      crc = 0xFFFF;
+      cabecalho[0] = byte;
+      retidos = 1;
+      estado = ESPERA_TIPO;
+      return PROTO_OCUPADO;
+    case ESPERA_TIPO:
+      if (byte < PROTO_MATRIZ || byte > PROTO_BRILHO)
+        return devolve(byte, msg);
+      tipo = byte;
+      cabecalho[retidos++] = byte;
+      crc = crc16(crc, byte);
+      estado = ESPERA_TAMANHO_0;
+      return PROTO_OCUPADO;
+    case ESPERA_TAMANHO_0:
+      tamanho = byte;
+      cabecalho[retidos++] = byte;
+      crc = crc16(crc, byte);
+      estado = ESPERA_TAMANHO_1;
+      return PROTO_OCUPADO;
+    case ESPERA_TAMANHO_1:
+      tamanho |= byte << 8;
+      if (!cabecalho_valido(tipo, tamanho))
+        return devolve(byte, msg);
+      crc = crc16(crc, byte);
+      recebidos = 0;
+      estado = ESPERA_DADOS;                // Todo tipo aceito tem pelo menos um byte de dados
+      return PROTO_OCUPADO;
+    case ESPERA_DADOS:
+      dados[recebidos++] = byte;
+      crc = crc16(crc, byte);
+      if (recebidos == tamanho)
+        estado = ESPERA_CRC_0;
+      return PROTO_OCUPADO;
+    case ESPERA_CRC_0:
+      crc_recebido = byte;
+      estado = ESPERA_CRC_1;
+      return PROTO_OCUPADO;
+    case ESPERA_CRC_1:
+      crc_recebido |= byte << 8;
+      estado = ESPERA_SYNC;
+      if (crc_recebido != crc) {
+        erros++;
+        msg->tipo = tipo;
+        msg->tamanho = 0;                   // Nenhum byte a analisar de novo
+        return PROTO_ERRO;
+      }
+      dados[tamanho] = 0;
+      msg->tipo = tipo;
+      msg->tamanho = tamanho;
+      msg->dados = dados;
+      return PROTO_PRONTO;
+  }
+  return PROTO_LIVRE;
+}
+
+uint32_t protocolo_erros()
+{
+  return erros;
+}
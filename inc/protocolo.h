@@ -0,0 +1,52 @@
+#include "pico/stdlib.h"
+
+// Protocolo binário em quadros, misturado ao fluxo de caracteres da serial:
+//
+//   0xA5 | tipo | tamanho (16 bits, LE) | dados (tamanho bytes) | CRC-16 (LE)
+//
+// O CRC-16/CCITT-FALSE (polinômio 0x1021, inicial 0xFFFF) cobre tipo, tamanho e dados.
+// Fora de um quadro os bytes seguem o tratamento de um caractere por vez. 0xA5 pode aparecer
+// no texto digitado (em UTF-8, 'å' é C3 A5), então o cabeçalho é conferido assim que chega:
+// tipo conhecido e tamanho possível para o tipo. Se não for, ou se o cabeçalho ficar
+// incompleto por PROTO_TIMEOUT_US, os bytes retidos são devolvidos (PROTO_DEVOLVE) para o
+// tratamento de caracteres. Um cabeçalho aceito por acaso consome os bytes seguintes até o
+// CRC recusá-los ou o timeout abandonar o quadro; é isso que ressincroniza o fluxo, não o
+// valor do byte de sincronismo. Cada quadro completo é respondido com PROTO_ACK ou, se
+// inválido, PROTO_NAK; um quadro abandonado nos dados também recebe PROTO_NAK. O timeout só é
+// conferido quando o byte seguinte chega: um quadro interrompido de vez fica pendente (e sem
+// NAK) até a serial receber mais alguma coisa.
+#define PROTO_SYNC 0xA5
+#define PROTO_ACK 0x06
+#define PROTO_NAK 0x15
+#define PROTO_MAX_DADOS (4 + 128 * 8)       // Maior mensagem: blit da tela inteira
+#define PROTO_TAMANHO_MATRIZ (3 * LED_COUNT)    // Mensagem da matriz: LED_COUNT x (R, G, B) (matriz.h)
+#define PROTO_CABECALHO 4                   // Sincronismo, tipo e tamanho: o máximo devolvido
+#define PROTO_TIMEOUT_US 100000             // Pausa máxima entre bytes de um mesmo quadro
+
+typedef enum {
+  PROTO_MATRIZ = 0x01,                      // LED_COUNT x (R, G, B), linha a linha a partir do topo
+  PROTO_BLIT = 0x02,                        // x, página, largura, páginas, dados (páginas x largura)
+  PROTO_TEXTO = 0x03,                       // x, y, caracteres (sem terminador)
+  PROTO_TIMEOUT = 0x04,                     // Tempo de inatividade em ms (32 bits, LE)
+  PROTO_BRILHO = 0x05                       // Brilho global da matriz (1 byte, 0 a 255)
+} proto_tipo_t;
+
+typedef enum {
+  PROTO_LIVRE,                              // Byte fora de quadro: tratar como caractere
+  PROTO_OCUPADO,                            // Byte consumido por um quadro em andamento
+  PROTO_PRONTO,                             // Quadro completo e válido em *msg
+  PROTO_ERRO,                               // Quadro descartado (CRC ou timeout nos dados); no
+                                            // timeout o byte atual volta em msg->dados para
+                                            // ser analisado de novo (msg->tamanho == 1)
+  PROTO_DEVOLVE                             // Cabeçalho recusado: os bytes em msg->dados (o
+                                            // primeiro é o 0xA5) voltam a ser caracteres
+} proto_resultado_t;
+
+typedef struct {
+  uint8_t tipo;
+  uint16_t tamanho;
+  const uint8_t *dados;                     // Válido até o próximo byte; em PROTO_PRONTO, dados[tamanho] == 0
+} proto_msg_t;
+
+proto_resultado_t protocolo_byte(uint8_t byte, proto_msg_t *msg);
+uint32_t protocolo_erros();
@@ -0,0 +1,49 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Fila circular de bytes para um produtor e um consumidor (ex.: IRQ de recepção escreve,
+// laço principal lê). Não usa travas: cada lado só altera o próprio índice, e os índices
+// crescem livremente (a posição é o índice módulo RINGBUF_SIZE).
+#ifndef RINGBUF_SIZE
+#define RINGBUF_SIZE 1024                   // Capacidade em bytes; deve ser potência de 2
+#endif
+
+#if RINGBUF_SIZE & (RINGBUF_SIZE - 1)
+#error "RINGBUF_SIZE deve ser potência de 2"
+#endif
+
+typedef struct {
+  volatile uint32_t head;                   // Próxima escrita (alterado só pelo produtor)
+  volatile uint32_t tail;                   // Próxima leitura (alterado só pelo consumidor)
+  volatile uint32_t overflow;               // Bytes descartados por falta de espaço
+  uint8_t data[RINGBUF_SIZE];
+} ringbuf_t;
+
+static inline uint32_t ringbuf_count(const ringbuf_t *rb) {
+  return rb->head - rb->tail;
+}
+
+// Produtor: retorna false (e conta o descarte) se a fila estiver cheia
+static inline bool ringbuf_put(ringbuf_t *rb, uint8_t byte) {
+  uint32_t head = rb->head;
+  if (head - rb->tail >= RINGBUF_SIZE) {
+    rb->overflow++;
+    return false;
+  }
+  rb->data[head & (RINGBUF_SIZE - 1)] = byte;
+  __dmb();                                  // O byte deve estar visível antes do novo índice
+  rb->head = head + 1;
+  return true;
+}
+
+// Consumidor: retorna false se a fila estiver vazia
+static inline bool ringbuf_get(ringbuf_t *rb, uint8_t *byte) {
+  uint32_t tail = rb->tail;
+  if (tail == rb->head)
+    return false;
+  __dmb();
+  *byte = rb->data[tail & (RINGBUF_SIZE - 1)];
+  __dmb();                                  // Lê o byte antes de liberar a posição
+  rb->tail = tail + 1;
+  return true;
+}
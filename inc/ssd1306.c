@@ -1,116 +1,473 @@
+#include <stdio.h>
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "perf.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
+// Custo em bytes no barramento para reposicionar a janela de endereçamento (0x00 + 6 comandos)
+#define SSD1306_WINDOW_COST 7
+// Maior lista de comandos enviada numa única transação
+#define SSD1306_CMD_LIST_MAX 32
+// Palavras que antecedem os dados no envio assíncrono: 6 pares (0x80, comando)
+#define SSD1306_ASYNC_HEADER 12
+
+static ssd1306_t *dma_owner[NUM_DMA_CHANNELS];
+
+// Os trechos sujos têm SSD1306_MAX_PAGES entradas; o limite explícito também deixa o
+// compilador ver que o índice nunca passa delas
+static void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  if (page >= SSD1306_MAX_PAGES)
+    return;
+  if (x0 < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x0;
+  if (x1 > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x1;
+}
+
+static void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < SSD1306_MAX_PAGES; ++p) {
+    ssd->dirty_x0[p] = 0xFF;
+    ssd->dirty_x1[p] = 0;
+  }
+}
+
+// Posição em ram_buffer do byte da página 0 da coluna x. No modo de endereçamento vertical
+// cada coluna ocupa `pages` bytes consecutivos, depois do prefixo 0x40.
+static inline size_t ssd1306_column(const ssd1306_t *ssd, uint8_t x) {
+  return (size_t)x * ssd->pages + 1;
+}
+
+// Toda escrita bloqueante passa por aqui para contabilizar o tráfego
+static void ssd1306_write(ssd1306_t *ssd, const uint8_t *src, size_t len) {
+  i2c_write_blocking(ssd->i2c_port, ssd->address, src, len, false);
+  ssd->stats.transactions++;
+  ssd->stats.bytes += len + 1;
+}
+
+static void ssd1306_set_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t window[] = { SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1 };
+  ssd1306_command_list(ssd, window, sizeof(window));
+}
+
+// A altura é arredondada para baixo a um múltiplo de 8 e limitada a 8 * SSD1306_MAX_PAGES
+// (de 8 a 64 linhas), o tamanho dos trechos sujos por página.
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+  if (height > 8 * SSD1306_MAX_PAGES)
+    height = 8 * SSD1306_MAX_PAGES;
+  height &= ~7u;
+  if (height < 8)
+    height = 8;
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
+  ssd->external_vcc = external_vcc;
   ssd->bufsize = ssd->pages * ssd->width + 1;
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->page_buffer = calloc(ssd->width + 1, sizeof(uint8_t));
+  ssd->page_buffer[0] = 0x40;
+  ssd->shadow = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->shadow_valid = false;
+  ssd1306_clear_dirty(ssd);
+  ssd->dma_buffer = NULL;
+  ssd->dma_chan = -1;
+  ssd->on_done = NULL;
+  ssd->on_done_data = NULL;
+  ssd->stats = (ssd1306_stats_t){0};
+  ssd->start_line = 0;
 }
 
+// Multiplexação e ligação dos COM seguem a altura do painel: 64 linhas usam COM alternados
+// (0x12), 32 linhas sequenciais (0x02). Com VCC externo a bomba de carga fica desligada.
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  const uint8_t init_sequence[] = {
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, ssd->height - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, ssd->height > 32 ? 0x12 : 0x02,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, ssd->external_vcc ? 0x22 : 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, ssd->external_vcc ? 0x10 : 0x14,
+    SET_DISP | 0x01
+  };
+  ssd1306_command_list(ssd, init_sequence, sizeof(init_sequence));
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_wait(ssd);
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  ssd1306_write(ssd, ssd->port_buffer, 2);
+}
+
+// Envia uma lista de comandos numa única transação, precedida do byte de controle 0x00
+// (Co = 0, D/C = 0). Listas maiores que SSD1306_CMD_LIST_MAX são divididas em blocos.
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buffer[SSD1306_CMD_LIST_MAX + 1];
+  buffer[0] = 0x00;
+  ssd1306_wait(ssd);
+  while (len) {
+    size_t chunk = len < SSD1306_CMD_LIST_MAX ? len : SSD1306_CMD_LIST_MAX;
+    memcpy(buffer + 1, commands, chunk);
+    ssd1306_write(ssd, buffer, chunk + 1);
+    commands += chunk;
+    len -= chunk;
+  }
 }
 
+// Primeira e última coluna que diferem do que o display já mostra (todas, se a cópia ainda
+// não for válida). Retorna false se o quadro for idêntico.
+static bool ssd1306_changed_columns(ssd1306_t *ssd, uint8_t *x0, uint8_t *x1) {
+  if (!ssd->shadow_valid) {
+    *x0 = 0;
+    *x1 = ssd->width - 1;
+    return true;
+  }
+  int first = -1, last = -1;
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+    size_t i = ssd1306_column(ssd, x);
+    if (memcmp(ssd->ram_buffer + i, ssd->shadow + i, ssd->pages)) {
+      if (first < 0)
+        first = x;
+      last = x;
+    }
+  }
+  *x0 = first;
+  *x1 = last;
+  return first >= 0;
+}
+
+// Estreita o trecho sujo de uma página às colunas que de fato mudaram
+static void ssd1306_trim_dirty(ssd1306_t *ssd, uint8_t p) {
+  uint8_t x0 = ssd->dirty_x0[p], x1 = ssd->dirty_x1[p];
+  while (x0 <= x1 && ssd->ram_buffer[ssd1306_column(ssd, x0) + p] == ssd->shadow[ssd1306_column(ssd, x0) + p])
+    ++x0;
+  while (x1 > x0 && ssd->ram_buffer[ssd1306_column(ssd, x1) + p] == ssd->shadow[ssd1306_column(ssd, x1) + p])
+    --x1;
+  ssd->dirty_x0[p] = x0 <= x1 ? x0 : 0xFF;
+  ssd->dirty_x1[p] = x0 <= x1 ? x1 : 0;
+}
+
+// Colunas x0..x1 de todas as páginas numa única transação. No modo de endereçamento
+// vertical elas já são contíguas no buffer; o byte anterior é trocado temporariamente
+// pelo prefixo de dados.
+static void ssd1306_send_block(ssd1306_t *ssd, uint8_t x0, uint8_t x1) {
+  size_t len = (size_t)(x1 - x0 + 1) * ssd->pages;
+  uint8_t *start = ssd->ram_buffer + ssd1306_column(ssd, x0) - 1;
+  uint8_t saved = *start;
+  *start = 0x40;
+  ssd1306_set_window(ssd, x0, x1, 0, ssd->pages - 1);
+  ssd1306_write(ssd, start, len + 1);
+  *start = saved;
+  memcpy(ssd->shadow + ssd1306_column(ssd, x0), start + 1, len);
+}
+
+// Envia o quadro inteiro, exceto as colunas que o display já mostra iguais
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  PERF_BEGIN(PERF_SEND_DATA);
+  uint8_t x0, x1;
+  if (ssd1306_changed_columns(ssd, &x0, &x1))
+    ssd1306_send_block(ssd, x0, x1);
+  else
+    ssd->stats.skipped++;
+  ssd->shadow_valid = true;
+  ssd1306_clear_dirty(ssd);
+  PERF_END(PERF_SEND_DATA);
+}
+
+// Envia apenas as colunas alteradas desde o último envio. Escolhe entre uma janela
+// por página suja ou um único bloco cobrindo todas as páginas, o que custar menos bytes.
+// Trechos marcados mas redesenhados com o mesmo conteúdo são descartados antes.
+void ssd1306_flush(ssd1306_t *ssd) {
+  uint8_t x0 = 0xFF, x1 = 0;
+  size_t span_cost = 0;
+  bool marked = false;
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    if (ssd->dirty_x0[p] > ssd->dirty_x1[p])
+      continue;
+    marked = true;
+    if (ssd->shadow_valid)
+      ssd1306_trim_dirty(ssd, p);
+    if (ssd->dirty_x0[p] > ssd->dirty_x1[p])
+      continue;
+    span_cost += (ssd->dirty_x1[p] - ssd->dirty_x0[p] + 1) + 1 + SSD1306_WINDOW_COST;
+    if (ssd->dirty_x0[p] < x0)
+      x0 = ssd->dirty_x0[p];
+    if (ssd->dirty_x1[p] > x1)
+      x1 = ssd->dirty_x1[p];
+  }
+  if (x0 > x1) {
+    if (marked)
+      ssd->stats.skipped++;
+    return;
+  }
+
+  PERF_BEGIN(PERF_FLUSH);
+  size_t block_cost = (size_t)(x1 - x0 + 1) * ssd->pages + 1 + SSD1306_WINDOW_COST;
+  if (block_cost <= span_cost) {
+    ssd1306_send_block(ssd, x0, x1);
+  } else {
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      uint8_t px0 = ssd->dirty_x0[p], px1 = ssd->dirty_x1[p];
+      if (px0 > px1)
+        continue;
+      uint8_t len = 0;
+      for (uint8_t x = px0; x <= px1; ++x) {
+        size_t i = ssd1306_column(ssd, x) + p;
+        ssd->page_buffer[++len] = ssd->ram_buffer[i];
+        ssd->shadow[i] = ssd->ram_buffer[i];
+      }
+      ssd1306_set_window(ssd, px0, px1, p, p);
+      ssd1306_write(ssd, ssd->page_buffer, len + 1);
+    }
+  }
+  ssd1306_clear_dirty(ssd);
+  PERF_END(PERF_FLUSH);
+}
+
+static void ssd1306_dma_irq_handler(void) {
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+    ssd1306_t *ssd = dma_owner[ch];
+    if (ssd && dma_channel_get_irq0_status(ch)) {
+      dma_channel_acknowledge_irq0(ch);
+      if (ssd->on_done)
+        ssd->on_done(ssd, ssd->on_done_data);
+    }
+  }
+}
+
+static void ssd1306_dma_setup(ssd1306_t *ssd) {
+  static bool irq_ready = false;
+  ssd->dma_chan = dma_claim_unused_channel(true);
+  ssd->dma_buffer = calloc(ssd->bufsize + SSD1306_ASYNC_HEADER, sizeof(uint16_t));
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_chan, &c, &i2c_get_hw(ssd->i2c_port)->data_cmd,
+                        ssd->dma_buffer, ssd->bufsize + SSD1306_ASYNC_HEADER, false);
+
+  dma_owner[ssd->dma_chan] = ssd;
+  if (!irq_ready) {
+    irq_add_shared_handler(DMA_IRQ_0, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    irq_ready = true;
+  }
+  dma_channel_set_irq0_enabled(ssd->dma_chan, true);
+}
+
+// Copia as colunas alteradas para o buffer do DMA e retorna sem esperar a transmissão, de
+// modo que o próximo quadro já pode ser desenhado em ram_buffer. Janela e dados seguem numa
+// única transação: cada comando leva o prefixo 0x80 (Co = 1) e os dados o prefixo 0x40.
+// Se o quadro anterior ainda estiver no barramento, espera por ele antes de reaproveitar o
+// buffer. Um quadro idêntico ao exibido não é enviado (e on_done não é chamado).
+void ssd1306_send_data_async(ssd1306_t *ssd) {
+  PERF_BEGIN(PERF_SEND_ASYNC);
+  uint8_t x0, x1;
+  if (!ssd1306_changed_columns(ssd, &x0, &x1)) {
+    ssd->stats.skipped++;
+    ssd1306_clear_dirty(ssd);
+    PERF_END(PERF_SEND_ASYNC);
+    return;
+  }
+  if (ssd->dma_chan < 0)
+    ssd1306_dma_setup(ssd);
+  ssd1306_wait(ssd);
+
+  const uint8_t window[SSD1306_ASYNC_HEADER / 2] = {
+    SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, 0, ssd->pages - 1
+  };
+  uint16_t *out = ssd->dma_buffer;
+  for (uint8_t i = 0; i < sizeof(window); ++i) {
+    *out++ = 0x80;
+    *out++ = window[i];
+  }
+  size_t len = (size_t)(x1 - x0 + 1) * ssd->pages;
+  const uint8_t *src = ssd->ram_buffer + ssd1306_column(ssd, x0);
+  *out++ = 0x40;
+  for (size_t i = 0; i < len; ++i)
+    *out++ = src[i];
+  out[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  memcpy(ssd->shadow + ssd1306_column(ssd, x0), src, len);
+  ssd->shadow_valid = true;
+  ssd1306_clear_dirty(ssd);
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  dma_channel_transfer_from_buffer_now(ssd->dma_chan, ssd->dma_buffer, len + 1 + SSD1306_ASYNC_HEADER);
+  ssd->stats.transactions++;
+  ssd->stats.bytes += len + 1 + SSD1306_ASYNC_HEADER + 1;
+  PERF_END(PERF_SEND_ASYNC);
+}
+
+// Verdadeiro enquanto houver bytes do envio assíncrono no DMA, na FIFO ou no barramento,
+// inclusive de outro painel ligado ao mesmo controlador I2C. Consulta só o hardware, então
+// pode ser usada também em contexto de interrupção.
+bool ssd1306_busy(ssd1306_t *ssd) {
+  if (ssd->dma_chan >= 0 && dma_channel_is_busy(ssd->dma_chan))
+    return true;
+  uint32_t status = i2c_get_hw(ssd->i2c_port)->status;
+  return !(status & I2C_IC_STATUS_TFE_BITS) || (status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// Verdadeiro se alguma página foi alterada desde o último envio
+bool ssd1306_dirty(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < ssd->pages; ++p)
+    if (ssd->dirty_x0[p] <= ssd->dirty_x1[p])
+      return true;
+  return false;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+}
+
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_callback_t callback, void *user_data) {
+  ssd->on_done = callback;
+  ssd->on_done_data = user_data;
+}
+
+// Copia os pixels do quadro atual (bufsize - 1 bytes, sem o prefixo 0x40) para frame
+void ssd1306_save_frame(ssd1306_t *ssd, uint8_t *frame) {
+  memcpy(frame, ssd->ram_buffer + 1, ssd->bufsize - 1);
+}
+
+// Substitui o quadro atual por um salvo com ssd1306_save_frame(); a tela toda fica suja
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame) {
+  memcpy(ssd->ram_buffer + 1, frame, ssd->bufsize - 1);
+  for (uint8_t p = 0; p < ssd->pages; ++p)
+    ssd1306_mark_dirty(ssd, p, 0, ssd->width - 1);
+}
+
+// Copia um bloco já no formato do controlador: pages linhas de width bytes, cada byte uma
+// coluna de 8 pixels com o de cima no bit 0. O que passar da borda da tela é descartado.
+void ssd1306_blit(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t width, uint8_t pages, const uint8_t *data) {
+  if (x >= ssd->width || page >= ssd->pages)
+    return;
+  uint8_t columns = width < ssd->width - x ? width : ssd->width - x;
+  for (uint8_t p = 0; p < pages && page + p < ssd->pages; ++p) {
+    const uint8_t *row = data + p * width;
+    for (uint8_t i = 0; i < columns; ++i)
+      ssd->ram_buffer[ssd1306_column(ssd, x + i) + page + p] = row[i];
+    if (columns)
+      ssd1306_mark_dirty(ssd, page + p, x, x + columns - 1);
+  }
+}
+
+// Imprime o quadro no stdout como PBM ASCII (P1), na orientação em que aparece na tela,
+// considerando a linha de início. Só texto, para não ser alterado pela conversão de "\n".
+void ssd1306_dump_pbm(ssd1306_t *ssd) {
+  printf("P1\n%u %u\n", ssd->width, ssd->height);
+  for (uint8_t y = 0; y < ssd->height; ++y) {
+    uint8_t line = (y + ssd->start_line) % ssd->height;
+    for (uint8_t x = 0; x < ssd->width; ++x)
+      putchar(ssd->ram_buffer[ssd1306_column(ssd, x) + (line >> 3)] & (1 << (line & 7)) ? '1' : '0');
+    putchar('\n');
+  }
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = ssd1306_column(ssd, x) + (y >> 3);
   uint8_t pixel = (y & 0b111);
+  ssd1306_mark_dirty(ssd, y >> 3, x, x);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// O buffer guarda 8 linhas por byte e as páginas de uma mesma coluna em bytes consecutivos
+// (ssd1306_column(ssd, x) + (y >> 3)). As rotinas abaixo calculam as máscaras das bordas uma vez e
+// escrevem bytes inteiros no meio, em vez de um ssd1306_pixel() por ponto.
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+// Trecho vertical y0..y1 da coluna x: máscara na primeira e na última página, bytes cheios entre elas.
+static void ssd1306_vspan(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+  uint8_t first = 0xFF << (y0 & 0b111);
+  uint8_t last = 0xFF >> (7 - (y1 & 0b111));
+  uint8_t *column = ssd->ram_buffer + ssd1306_column(ssd, x);
+
+  if (p0 == p1)
+    first &= last;
+  if (value)
+    column[p0] |= first;
+  else
+    column[p0] &= ~first;
+  ssd1306_mark_dirty(ssd, p0, x, x);
+  if (p0 == p1)
+    return;
+
+  for (uint8_t p = p0 + 1; p < p1; ++p) {
+    column[p] = value ? 0xFF : 0x00;
+    ssd1306_mark_dirty(ssd, p, x, x);
+  }
+  if (value)
+    column[p1] |= last;
+  else
+    column[p1] &= ~last;
+  ssd1306_mark_dirty(ssd, p1, x, x);
 }
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  PERF_BEGIN(PERF_FILL);
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  for (uint8_t p = 0; p < ssd->pages; ++p)
+    ssd1306_mark_dirty(ssd, p, 0, ssd->width - 1);
+  PERF_END(PERF_FILL);
+}
 
+// Desloca o conteúdo para cima em páginas inteiras (8 linhas cada) e preenche as páginas
+// liberadas embaixo. Cada coluna guarda as páginas em bytes consecutivos, então basta um
+// memmove curto por coluna em vez de redesenhar a tela.
+void ssd1306_scroll_pages(ssd1306_t *ssd, uint8_t pages, bool value) {
+  if (pages > ssd->pages)
+    pages = ssd->pages;
+  uint8_t keep = ssd->pages - pages;
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+    uint8_t *column = ssd->ram_buffer + ssd1306_column(ssd, x);
+    memmove(column, column + pages, keep);
+    memset(column + keep, value ? 0xFF : 0x00, pages);
+  }
+  for (uint8_t p = 0; p < ssd->pages; ++p)
+    ssd1306_mark_dirty(ssd, p, 0, ssd->width - 1);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (width == 0 || height == 0)
+    return;
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
 
-  if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+  ssd1306_hline(ssd, left, right, top, value);
+  ssd1306_hline(ssd, left, right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom, value);
+  ssd1306_vline(ssd, right, top, bottom, value);
+
+  if (fill && width > 2 && height > 2) {
+    uint8_t y0 = top + 1, y1 = bottom - 1;
+    if (y1 >= ssd->height)
+      y1 = ssd->height - 1;
+    for (uint8_t x = left + 1; x < right && x < ssd->width && y0 <= y1; ++x)
+      ssd1306_vspan(ssd, x, y0, y1, value);
   }
 }
 
@@ -144,56 +501,77 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y >= ssd->height || x0 >= ssd->width || x0 > x1)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  uint8_t page = y >> 3;
+  uint8_t bit = 1 << (y & 0b111);
+  uint8_t *byte = ssd->ram_buffer + ssd1306_column(ssd, x0) + page;
+  for (uint8_t x = x0; x <= x1; ++x, byte += ssd->pages) {
+    if (value)
+      *byte |= bit;
+    else
+      *byte &= ~bit;
+  }
+  ssd1306_mark_dirty(ssd, page, x0, x1);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x >= ssd->width || y0 >= ssd->height || y0 > y1)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  ssd1306_vspan(ssd, x, y0, y1, value);
 }
 
-// Função para desenhar um caractere
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+// Combina os bits de uma coluna do glifo com um byte do buffer, só dentro de mask
+static inline void ssd1306_blend(uint8_t *byte, uint8_t bits, uint8_t mask, ssd1306_text_mode_t mode)
 {
-  uint16_t index = 0;
-  char ver=c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }else if (c >= 'a' && c <= 'z')
-  {
-    index = (c - 'a' + 37) * 8; // Para letras minúsculas
-  }else if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }else if(c == ' '){
-    index = 0; // Espaço
-  }else if(c == '.'){
-    index = 63*8; // Ponto
-  }else if(c == ':'){
-    index = 66*8; // Dois pontos
-  }else if(c == ','){
-    index = 64*8; // Vírgula
-  }else if(c == '!'){
-    index = 65*8; // Exclamação
-  }
-  for (uint8_t i = 0; i < 8; ++i)
+  if (mode == SSD1306_TEXT_TRANSPARENT)
+    *byte |= bits & mask;
+  else
+    *byte = (*byte & ~mask) | (bits & mask);
+}
+
+// Função para desenhar um caractere. A fonte já está em colunas de 8 pixels na vertical,
+// no mesmo formato das páginas do display: com y múltiplo de 8 cada coluna é um byte
+// copiado; caso contrário, a coluna é dividida em duas páginas com um deslocamento.
+void ssd1306_draw_char_mode(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, ssd1306_text_mode_t mode)
+{
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  const uint8_t *glyph = font + (font_index[(uint8_t)c] << 3);
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  uint8_t columns = ssd->width - x < 8 ? ssd->width - x : 8;
+  bool lower = shift && page + 1 < ssd->pages;
+  uint8_t *column = ssd->ram_buffer + ssd1306_column(ssd, x) + page;
+
+  for (uint8_t i = 0; i < columns; ++i, column += ssd->pages)
   {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
+    uint8_t line = mode == SSD1306_TEXT_INVERSE ? ~glyph[i] : glyph[i];
+    ssd1306_blend(column, line << shift, 0xFF << shift, mode);
+    if (lower)
+      ssd1306_blend(column + 1, line >> (8 - shift), 0xFF >> (8 - shift), mode);
   }
+  ssd1306_mark_dirty(ssd, page, x, x + columns - 1);
+  if (lower)
+    ssd1306_mark_dirty(ssd, page + 1, x, x + columns - 1);
+}
+
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_char_mode(ssd, c, x, y, SSD1306_TEXT_NORMAL);
 }
 
 // Função para desenhar uma string
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+void ssd1306_draw_string_mode(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, ssd1306_text_mode_t mode)
 {
+  PERF_BEGIN(PERF_DRAW_STRING);
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
+    ssd1306_draw_char_mode(ssd, *str++, x, y, mode);
     x += 8;
     if (x + 8 >= ssd->width)
     {
@@ -205,4 +583,81 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
       break;
     }
   }
-}
\ No newline at end of file
+  PERF_END(PERF_DRAW_STRING);
+}
+
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_string_mode(ssd, str, x, y, SSD1306_TEXT_NORMAL);
+}
+
+void ssd1306_console_init(ssd1306_console_t *con, ssd1306_t *ssd) {
+  con->ssd = ssd;
+  ssd1306_console_reset(con);
+}
+
+// Limpa o buffer e volta a linha de início para 0, de modo que o buffer volte a
+// corresponder à tela. O conteúdo só é enviado no próximo flush/send_data.
+void ssd1306_console_reset(ssd1306_console_t *con) {
+  con->top = 0;
+  con->column = 0;
+  ssd1306_fill(con->ssd, false);
+  con->ssd->start_line = 0;
+  ssd1306_command(con->ssd, SET_DISP_START_LINE);
+}
+
+// Página da RAM exibida na última linha da tela, onde fica o cursor
+static uint8_t ssd1306_console_bottom(const ssd1306_console_t *con) {
+  return (con->top + con->ssd->pages - 1) % con->ssd->pages;
+}
+
+// Custa o envio de uma página e um comando: a página do topo é apagada e enviada junto com
+// o que estiver pendente, e só então a linha de início avança para exibi-la embaixo.
+// A linha de início percorre as 64 linhas da RAM do controlador; em painéis mais baixos o
+// anel não fecha, então o buffer é deslocado e reenviado.
+void ssd1306_console_newline(ssd1306_console_t *con) {
+  ssd1306_t *ssd = con->ssd;
+  con->column = 0;
+  if (ssd->pages < SSD1306_MAX_PAGES) {
+    ssd1306_scroll_pages(ssd, 1, false);
+    ssd1306_flush(ssd);
+    return;
+  }
+  uint8_t page = con->top;
+  for (uint8_t x = 0; x < ssd->width; ++x)
+    ssd->ram_buffer[ssd1306_column(ssd, x) + page] = 0;
+  ssd1306_mark_dirty(ssd, page, 0, ssd->width - 1);
+  ssd1306_flush(ssd);
+
+  con->top = (con->top + 1) % ssd->pages;
+  ssd->start_line = con->top * 8;
+  ssd1306_command(ssd, SET_DISP_START_LINE | ssd->start_line);
+}
+
+// Escreve no buffer; os caracteres da linha atual aparecem no próximo ssd1306_flush() (ou
+// ao passar para a linha seguinte). Trata '\n', '\r' e '\b' e quebra linhas longas.
+void ssd1306_console_putc(ssd1306_console_t *con, char c) {
+  uint8_t y = ssd1306_console_bottom(con) * 8;
+  if (c == '\n') {
+    ssd1306_console_newline(con);
+  } else if (c == '\r') {
+    con->column = 0;
+  } else if (c == '\b') {
+    if (con->column > 0) {
+      con->column--;
+      ssd1306_draw_char(con->ssd, ' ', con->column * 8, y);
+    }
+  } else {
+    if (con->column >= con->ssd->width / 8) {
+      ssd1306_console_newline(con);
+      y = ssd1306_console_bottom(con) * 8;
+    }
+    ssd1306_draw_char(con->ssd, c, con->column * 8, y);
+    con->column++;
+  }
+}
+
+void ssd1306_console_puts(ssd1306_console_t *con, const char *str) {
+  while (*str)
+    ssd1306_console_putc(con, *str++);
+}
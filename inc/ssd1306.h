@@ -4,6 +4,7 @@
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -25,25 +26,82 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef enum {
+  SSD1306_TEXT_NORMAL,                    // Texto aceso sobre fundo apagado
+  SSD1306_TEXT_INVERSE,                   // Texto apagado sobre fundo aceso
+  SSD1306_TEXT_TRANSPARENT                // Acende só os pixels do glifo, preservando o fundo
+} ssd1306_text_mode_t;
+
+// Tráfego acumulado no barramento, para medir o custo de cada forma de envio
 typedef struct {
+  uint32_t transactions;                  // Transações I2C (START ... STOP)
+  uint32_t bytes;                         // Bytes transmitidos, incluindo o de endereço
+  uint32_t skipped;                       // Envios evitados: o display já mostrava o conteúdo
+} ssd1306_stats_t;
+
+typedef struct ssd1306_t ssd1306_t;
+typedef void (*ssd1306_callback_t)(ssd1306_t *ssd, void *user_data);
+
+struct ssd1306_t {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
-} ssd1306_t;
+  uint8_t *page_buffer;                   // Buffer de envio de uma página (0x40 + width bytes)
+  uint8_t *shadow;                        // Cópia do que já foi enviado, no layout de ram_buffer
+  bool shadow_valid;                      // false até o primeiro envio do quadro inteiro
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];    // Primeira coluna alterada de cada página
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];    // Última coluna alterada de cada página (x0 > x1: página limpa)
+  uint16_t *dma_buffer;                   // Quadro em transmissão, já no formato do registrador IC_DATA_CMD
+  int dma_chan;                           // Canal DMA (-1 até o primeiro envio assíncrono)
+  ssd1306_callback_t on_done;             // Chamado (em IRQ) quando o DMA entrega o último byte à FIFO
+  void *on_done_data;
+  ssd1306_stats_t stats;                  // Zerado em ssd1306_init()
+  uint8_t start_line;                     // Linha da RAM exibida no topo (SET_DISP_START_LINE)
+};
+
+// Console de texto em linhas de 8 pixels. A linha de início do display (SET_DISP_START_LINE)
+// funciona como deslocamento de um anel de páginas: uma linha nova apaga a página que sai do
+// topo, que passa a ser a última linha, em vez de deslocar e reenviar o quadro inteiro.
+typedef struct {
+  ssd1306_t *ssd;
+  uint8_t top;                            // Página da RAM exibida no topo da tela
+  uint8_t column;                         // Coluna do cursor, em caracteres
+} ssd1306_console_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_flush(ssd1306_t *ssd);
+void ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
+bool ssd1306_dirty(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_callback_t callback, void *user_data);
+
+void ssd1306_save_frame(ssd1306_t *ssd, uint8_t *frame);
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame);
+void ssd1306_dump_pbm(ssd1306_t *ssd);
+void ssd1306_blit(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t width, uint8_t pages, const uint8_t *data);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_scroll_pages(ssd1306_t *ssd, uint8_t pages, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_draw_char_mode(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, ssd1306_text_mode_t mode);
+void ssd1306_draw_string_mode(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, ssd1306_text_mode_t mode);
+
+void ssd1306_console_init(ssd1306_console_t *con, ssd1306_t *ssd);
+void ssd1306_console_reset(ssd1306_console_t *con);
+void ssd1306_console_newline(ssd1306_console_t *con);
+void ssd1306_console_putc(ssd1306_console_t *con, char c);
+void ssd1306_console_puts(ssd1306_console_t *con, const char *str);
@@ -0,0 +1,126 @@
+#include <string.h>
+#include "texto.h"
+#include "ssd1306.h"
+#include "matriz.h"
+#include "ringbuf.h"
+
+#define TEXTO_LARGURA_GLIFO (5 + TEXTO_ESPACO_GLIFO)
+
+static ssd1306_t *tela;
+
+// Caracteres ainda não desenhados. O terminal consome rápido; o letreiro, uma coluna por
+// passo, por isso cada saída tem a própria fila.
+static ringbuf_t pendente_tela;
+static ringbuf_t pendente_matriz;
+
+// Letreiro: colunas visíveis (linha y no bit y) e posição dentro do glifo atual
+static uint8_t colunas[MATRIZ_WIDTH];
+static char glifo_atual;
+static uint coluna_glifo = TEXTO_LARGURA_GLIFO;
+
+// Terminal: console do display (linha nova = uma página e um comando) e último caractere
+// recebido, para tratar "\r\n" como uma só quebra de linha
+static ssd1306_console_t console;
+static uint8_t anterior;
+
+void texto_init(ssd1306_t *ssd)
+{
+    tela = ssd;
+    ssd1306_console_init(&console, ssd);
+}
+
+// Limpa o letreiro e o terminal para começar o modo texto
+void texto_reset()
+{
+    memset(colunas, 0, sizeof(colunas));
+    glifo_atual = 0;
+    coluna_glifo = TEXTO_LARGURA_GLIFO;
+    anterior = 0;
+
+    npClear();
+    npWrite();
+    ssd1306_console_reset(&console);
+    ssd1306_send_data_async(tela);
+}
+
+// Sai do modo texto: descarta o que ainda não foi desenhado (texto_put() já não é mais
+// chamada) e devolve ao display a linha de início 0, que as outras telas pressupõem.
+void texto_fim()
+{
+    uint8_t c;
+    while (ringbuf_get(&pendente_tela, &c))
+        ;
+    while (ringbuf_get(&pendente_matriz, &c))
+        ;
+    ssd1306_console_reset(&console);
+}
+
+// Enfileira um caractere recebido. Quebras de linha viram espaço no letreiro e os demais
+// caracteres de controle só valem para o terminal.
+void texto_put(uint8_t c)
+{
+    ringbuf_put(&pendente_tela, c);
+    if (c == '\r' || c == '\n')
+        ringbuf_put(&pendente_matriz, ' ');
+    else if (c >= ' ' && c < 0x7F)
+        ringbuf_put(&pendente_matriz, c);
+}
+
+// Avança o letreiro uma coluna. Retorna false se a matriz não mudou (letreiro vazio).
+static bool texto_passo_matriz()
+{
+    if (coluna_glifo >= TEXTO_LARGURA_GLIFO) {
+        uint8_t c;
+        glifo_atual = ringbuf_get(&pendente_matriz, &c) ? c : 0;
+        coluna_glifo = 0;
+    }
+    uint8_t nova = coluna_glifo < 5 ? npGlyphColumn(glifo_atual, coluna_glifo) : 0;
+    coluna_glifo++;
+
+    bool vazio = glifo_atual == 0;
+    for (uint x = 0; x < MATRIZ_WIDTH && vazio; x++)
+        vazio = colunas[x] == 0;
+    if (vazio) {
+        coluna_glifo = TEXTO_LARGURA_GLIFO;                     // Próximo caractere entra já no próximo passo
+        return false;
+    }
+
+    memmove(colunas, colunas + 1, MATRIZ_WIDTH - 1);
+    colunas[MATRIZ_WIDTH - 1] = nova;
+    for (uint x = 0; x < MATRIZ_WIDTH; x++)
+        npSetColumn(x, colunas[x], TEXTO_COR_R, TEXTO_COR_G, TEXTO_COR_B);
+    return true;
+}
+
+// Desenha no terminal até TEXTO_CARACTERES_POR_TICK caracteres. Retorna false se nada mudou.
+static bool texto_passo_tela()
+{
+    bool mudou = false;
+    uint8_t c;
+
+    for (uint n = 0; n < TEXTO_CARACTERES_POR_TICK && ringbuf_get(&pendente_tela, &c); n++) {
+        if (c == '\n' && anterior == '\r') {
+            // "\r\n" conta como uma só quebra de linha
+        } else if (c == '\r' || c == '\n') {
+            ssd1306_console_newline(&console);
+            mudou = true;
+        } else if (c == '\b' || c == 0x7F) {
+            ssd1306_console_putc(&console, '\b');
+            mudou = true;
+        } else if (c >= ' ') {
+            ssd1306_console_putc(&console, c);
+            mudou = true;
+        }
+        anterior = c;
+    }
+    return mudou;
+}
+
+// Um passo do modo texto: no máximo um quadro para a matriz e um para o display
+void texto_tick()
+{
+    if (texto_passo_matriz())
+        npWrite();
+    if (texto_passo_tela())
+        ssd1306_flush(tela);                                    // Só a linha do cursor, se ainda pendente
+}
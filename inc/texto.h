@@ -0,0 +1,21 @@
+#include "pico/stdlib.h"
+
+typedef struct ssd1306_t ssd1306_t;
+
+// Modo texto: os caracteres recebidos viram um letreiro que corre coluna a coluna na matriz
+// e um terminal de várias linhas no display. texto_put() só enfileira; o desenho é feito em
+// texto_tick(), chamado a uma taxa fixa, então o custo por passo não depende do ritmo de
+// chegada dos caracteres.
+#define TEXTO_TICK_MS 80                    // Período de um passo do letreiro
+#define TEXTO_CARACTERES_POR_TICK 16        // Máximo de caracteres desenhados no display por passo
+#define TEXTO_ESPACO_GLIFO 1                // Colunas apagadas entre dois glifos do letreiro
+
+#define TEXTO_COR_R 255                     // Cor do letreiro na matriz (antes do brilho global)
+#define TEXTO_COR_G 0
+#define TEXTO_COR_B 0
+
+void texto_init(ssd1306_t *ssd);
+void texto_reset();
+void texto_fim();
+void texto_put(uint8_t c);
+void texto_tick();
@@ -0,0 +1,131 @@
+// Medições das rotinas de desenho e de envio do display e da matriz, sobre o mock.
+//
+//   bench [repeticoes]
+//
+// Para cada operação imprime o tempo de CPU do computador por chamada (ns/op, útil para
+// comparar duas versões do código entre si, não para prever o tempo no RP2040) e o tráfego
+// gerado: bytes no I2C (com o de endereço), tempo desses bytes no fio a 400 kHz e palavras
+// entregues à FIFO do PIO. Nas operações que enviam, o ns/op inclui a decodificação feita
+// pelo modelo do display.
+#include <stdlib.h>
+#include "teste.h"
+#include "matriz.h"
+
+#define ENDERECO 0x3C
+#define LED_PIN 7
+
+static ssd1306_t ssd;
+
+static void op_fill(uint32_t i)
+{
+  ssd1306_fill(&ssd, i & 1);
+}
+
+static void op_rect(uint32_t i)
+{
+  ssd1306_rect(&ssd, 3, 3, 122, 58, i & 1, false);
+}
+
+static void op_rect_cheio(uint32_t i)
+{
+  ssd1306_rect(&ssd, 3, 3, 122, 58, i & 1, true);
+}
+
+static void op_line(uint32_t i)
+{
+  ssd1306_line(&ssd, 0, 0, 127, 63, i & 1);
+}
+
+static void op_char_alinhado(uint32_t i)
+{
+  ssd1306_draw_char(&ssd, 'A' + i % 26, (i * 8) % 120, 16);
+}
+
+static void op_char_desalinhado(uint32_t i)
+{
+  ssd1306_draw_char(&ssd, 'A' + i % 26, (i * 8) % 120, 13);
+}
+
+static void op_string(uint32_t i)
+{
+  ssd1306_draw_string(&ssd, i & 1 ? "EMBARCATECH U4C6" : "Werliarlinson", 0, 24);
+}
+
+static void op_send_data(uint32_t i)
+{
+  ssd1306_fill(&ssd, i & 1);
+  ssd1306_send_data(&ssd);
+}
+
+static void op_flush_char(uint32_t i)
+{
+  ssd1306_draw_char(&ssd, 'A' + i % 26, 100, 30);
+  ssd1306_flush(&ssd);
+}
+
+static void op_send_async(uint32_t i)
+{
+  ssd1306_fill(&ssd, i & 1);
+  ssd1306_send_data_async(&ssd);
+  ssd1306_wait(&ssd);
+}
+
+static void op_np_write(uint32_t i)
+{
+  npDrawGlyph('A' + i % 26, 255, 0, 0);
+  npWrite();
+}
+
+typedef struct {
+  const char *nome;
+  void (*op)(uint32_t i);
+} medicao_t;
+
+static const medicao_t medicoes[] = {
+  { "fill", op_fill },
+  { "rect", op_rect },
+  { "rect cheio", op_rect_cheio },
+  { "line diagonal", op_line },
+  { "draw_char y=16", op_char_alinhado },
+  { "draw_char y=13", op_char_desalinhado },
+  { "draw_string 16", op_string },
+  { "fill + send_data", op_send_data },
+  { "draw_char + flush", op_flush_char },
+  { "fill + send_async", op_send_async },
+  { "matriz: npWrite", op_np_write },
+};
+
+int main(int argc, char **argv)
+{
+  uint32_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+  if (!n)
+    n = 1;
+
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+  ssd1306_config(&ssd);
+  ssd1306_send_data(&ssd);
+  npInit(LED_PIN);
+
+  printf("%-20s %10s %12s %10s %14s\n", "operacao", "ns/op", "bytes I2C/op", "I2C us/op", "palavras PIO/op");
+  for (size_t m = 0; m < count_of(medicoes); m++) {
+    mock_espera_dma();
+    mock_limpa_registros();
+    uint32_t palavras = npGetStats().words;
+
+    uint64_t inicio = agora_ns();
+    for (uint32_t i = 0; i < n; i++)
+      medicoes[m].op(i);
+    uint64_t decorrido = agora_ns() - inicio;
+
+    mock_espera_dma();
+    const mock_barramento_t *b = mock_barramento(i2c_get_index(i2c1));
+    printf("%-20s %10.1f %12.1f %10.1f %14.1f\n", medicoes[m].nome, (double)decorrido / n,
+           (double)b->bytes / n, (double)b->ocupado_us / n, (double)(npGetStats().words - palavras) / n);
+    if (b->colisoes || b->sem_stop) {
+      printf("erro: %u escritas sobrepostas, %u transferencias sem STOP\n", b->colisoes, b->sem_stop);
+      return 1;
+    }
+  }
+  return 0;
+}
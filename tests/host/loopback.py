@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Loopback do protocolo serial: o firmware do computador (placa) de um lado de um
+pseudo-terminal e tools/protocolo.py do outro, como com a placa na porta USB.
+
+  loopback.py CAMINHO/placa CAMINHO/tools/protocolo.py
+
+Confere que cada comando da ferramenta recebe ACK, que um quadro inválido recebe NAK e que a
+imagem enviada por blit é a que a placa devolve no snapshot (Ctrl+P).
+"""
+import os
+import select
+import subprocess
+import sys
+import tempfile
+import time
+import tty
+
+LARGURA, ALTURA = 128, 64
+
+
+def le_snapshot(fd, limite=5.0):
+    """Lê a saída da placa até o PBM do display impresso pelo snapshot."""
+    dados = b""
+    fim = time.monotonic() + limite
+    while time.monotonic() < fim:
+        if select.select([fd], [], [], 0.1)[0]:
+            dados += os.read(fd, 4096)
+        inicio = dados.find(b"P1\n%d %d\n" % (LARGURA, ALTURA))
+        if inicio >= 0:
+            linhas = dados[inicio:].split(b"\n")[2:2 + ALTURA]
+            if len(linhas) == ALTURA and all(len(l) == LARGURA for l in linhas):
+                return [[c - 48 for c in l] for l in linhas]
+    raise TimeoutError("a placa não imprimiu o snapshot")
+
+
+def main(placa, ferramenta):
+    mestre, escravo = os.openpty()
+    tty.setraw(escravo)                             # Bytes binários passam sem tradução
+    porta = os.ttyname(escravo)
+    firmware = subprocess.Popen([placa], stdin=mestre, stdout=mestre)
+    os.close(mestre)
+    falhas = 0
+
+    def protocolo(*args, esperado=0):
+        nonlocal falhas
+        r = subprocess.run([sys.executable, ferramenta, porta, *args], timeout=60,
+                           stderr=subprocess.DEVNULL if esperado else None)
+        if r.returncode != esperado:
+            print(f"protocolo.py {' '.join(args)}: saída {r.returncode}, esperado {esperado}")
+            falhas += 1
+
+    try:
+        imagem = [[(x * y + x // 3) % 5 == 0 for x in range(LARGURA)] for y in range(ALTURA)]
+        with tempfile.NamedTemporaryFile("w", suffix=".pbm", delete=False) as f:
+            f.write("P1\n%d %d\n" % (LARGURA, ALTURA))
+            f.writelines("".join("1" if p else "0" for p in linha) + "\n" for linha in imagem)
+        protocolo("matriz", "ff0000")
+        protocolo("brilho", "100")
+        protocolo("texto", "0", "0", "loopback")
+        protocolo("timeout", "60000")
+        protocolo("timeout", "0", esperado=1)       # Recusado pela placa (NAK)
+        protocolo("bench", "10")
+        protocolo("blit", f.name)
+        os.unlink(f.name)
+
+        time.sleep(0.2)
+        while select.select([escravo], [], [], 0.1)[0]:  # Descarta o que veio antes
+            os.read(escravo, 4096)
+        os.write(escravo, b"\x10")                  # Ctrl+P
+        if le_snapshot(escravo) != [[int(p) for p in linha] for linha in imagem]:
+            print("o snapshot difere da imagem enviada por blit")
+            falhas += 1
+    finally:
+        os.close(escravo)                           # Fim da entrada: a placa termina
+        try:
+            firmware.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            firmware.kill()
+            print("a placa não terminou ao fechar a porta")
+            falhas += 1
+    return falhas != 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    sys.exit(main(sys.argv[1], sys.argv[2]))
@@ -0,0 +1,1191 @@
+// Implementação do SDK simulado (tests/host/sdk) e do modelo descrito em mock.h
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "mock.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "pico/multicore.h"
+#include "pico/util/queue.h"
+
+#define ALARMES_MAX 16                      // PICO_TIME_DEFAULT_ALARM_POOL_MAX_TIMERS
+
+static void falha(const char *msg)
+{
+  fprintf(stderr, "mock: %s\n", msg);
+  abort();
+}
+
+// ---------------------------------------------------------------------------------------
+// Relógio e interrupções
+
+static uint64_t agora = 0;
+static bool real = false;
+static uint64_t base_real;
+static _Thread_local uint32_t desabilitadas = 0;
+static bool em_irq = false;
+static int sev = 0;
+
+static uint64_t monotonico_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t relogio(void)
+{
+  if (real)
+    agora = monotonico_us() - base_real;
+  return agora;
+}
+
+static bool irq_permitida(void)
+{
+  return !desabilitadas && !em_irq;
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+  uint32_t antes = desabilitadas;
+  desabilitadas = 1;
+  return antes;
+}
+
+void restore_interrupts(uint32_t status)
+{
+  desabilitadas = status;
+}
+
+// ---------------------------------------------------------------------------------------
+// Alarmes
+
+typedef enum { ALARME_LIVRE, ALARME_PENDENTE, ALARME_EXECUTANDO } alarme_estado_t;
+
+typedef struct {
+  alarme_estado_t estado;
+  bool cancelado;                           // cancel_alarm() durante o próprio callback
+  alarm_id_t id;
+  uint64_t quando;
+  alarm_callback_t callback;
+  void *user_data;
+} alarme_t;
+
+static alarme_t alarmes[ALARMES_MAX];
+static alarm_id_t proximo_id = 1;
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+  (void)fire_if_past;
+  for (int i = 0; i < ALARMES_MAX; i++) {
+    alarme_t *a = &alarmes[i];
+    if (a->estado != ALARME_LIVRE)
+      continue;
+    *a = (alarme_t){ ALARME_PENDENTE, false, proximo_id++, relogio() + us, callback, user_data };
+    if (proximo_id <= 0)
+      proximo_id = 1;
+    return a->id;
+  }
+  return -1;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+  return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id)
+{
+  for (int i = 0; i < ALARMES_MAX; i++) {
+    alarme_t *a = &alarmes[i];
+    if (a->estado == ALARME_LIVRE || a->id != id || id <= 0)
+      continue;
+    if (a->estado == ALARME_EXECUTANDO) {
+      a->cancelado = true;
+      return false;
+    }
+    a->estado = ALARME_LIVRE;
+    return true;
+  }
+  return false;
+}
+
+static void dispara_alarme(alarme_t *a)
+{
+  a->estado = ALARME_EXECUTANDO;
+  a->cancelado = false;
+  em_irq = true;
+  int64_t r = a->callback(a->id, a->user_data);
+  em_irq = false;
+  if (r == 0 || a->cancelado) {
+    a->estado = ALARME_LIVRE;
+    return;
+  }
+  a->quando = r > 0 ? agora + (uint64_t)r : a->quando + (uint64_t)-r;
+  a->estado = ALARME_PENDENTE;
+}
+
+static int64_t repete(alarm_id_t id, void *user_data)
+{
+  (void)id;
+  repeating_timer_t *rt = user_data;
+  if (!rt->callback(rt)) {
+    rt->alarm_id = 0;
+    return 0;
+  }
+  return rt->delay_us;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+  if (!delay_us)
+    delay_us = 1;
+  out->delay_us = delay_us;
+  out->callback = callback;
+  out->user_data = user_data;
+  out->alarm_id = add_alarm_in_us(delay_us < 0 ? -delay_us : delay_us, repete, out, true);
+  return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+  return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer)
+{
+  bool ok = timer->alarm_id > 0 && cancel_alarm(timer->alarm_id);
+  timer->alarm_id = 0;
+  return ok;
+}
+
+// ---------------------------------------------------------------------------------------
+// Displays SSD1306
+
+static mock_painel_t paineis[MOCK_PAINEIS];
+static uint8_t total_paineis = 0;
+
+static mock_painel_t *painel(uint barramento, uint8_t endereco)
+{
+  for (uint8_t i = 0; i < total_paineis; i++)
+    if (paineis[i].barramento == barramento && paineis[i].endereco == endereco)
+      return &paineis[i];
+  if (total_paineis == MOCK_PAINEIS)
+    falha("displays demais");
+  mock_painel_t *p = &paineis[total_paineis++];
+  memset(p, 0, sizeof(*p));
+  p->barramento = barramento;
+  p->endereco = endereco;
+  p->modo = 2;                              // Valores após o reset do controlador
+  p->mux = 63;
+  p->com_pins = 0x12;
+  p->c1 = 127;
+  p->p1 = 7;
+  return p;
+}
+
+mock_painel_t *mock_painel(i2c_inst_t *i2c, uint8_t endereco)
+{
+  uint b = i2c_get_index(i2c);
+  for (uint8_t i = 0; i < total_paineis; i++)
+    if (paineis[i].barramento == b && paineis[i].endereco == endereco)
+      return &paineis[i];
+  return NULL;
+}
+
+bool mock_painel_pixel(const mock_painel_t *p, uint x, uint y)
+{
+  if (x > 127 || y > p->mux)
+    return false;
+  uint linha = (y + p->start_line) & 63;
+  return (p->gddram[linha >> 3][x] >> (linha & 7)) & 1;
+}
+
+static void painel_executa(mock_painel_t *p)
+{
+  uint8_t c = p->cmd;
+  p->comandos++;
+  if (c >= 0x40 && c <= 0x7F) {
+    p->start_line = c & 63;
+    return;
+  }
+  switch (c) {
+    case 0x20: p->modo = p->args[0] & 3; break;
+    case 0x21: p->c0 = p->args[0] & 127; p->c1 = p->args[1] & 127; p->coluna = p->c0; break;
+    case 0x22: p->p0 = p->args[0] & 7; p->p1 = p->args[1] & 7; p->pagina = p->p0; break;
+    case 0x8D: p->bomba = p->args[0]; break;
+    case 0xA8: p->mux = p->args[0] & 63; break;
+    case 0xD9: p->precarga = p->args[0]; break;
+    case 0xDA: p->com_pins = p->args[0]; break;
+    case 0xAE: p->ligado = false; break;
+    case 0xAF: p->ligado = true; break;
+    default: break;
+  }
+}
+
+static void painel_comando(mock_painel_t *p, uint8_t c)
+{
+  if (p->faltam) {
+    p->args[p->nargs++] = c;
+    if (--p->faltam == 0)
+      painel_executa(p);
+    return;
+  }
+  p->cmd = c;
+  p->nargs = 0;
+  switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      p->faltam = 1;
+      break;
+    case 0x21: case 0x22: case 0xA3:
+      p->faltam = 2;
+      break;
+    case 0x29: case 0x2A:
+      p->faltam = 5;
+      break;
+    case 0x26: case 0x27:
+      p->faltam = 6;
+      break;
+    default:
+      painel_executa(p);
+      break;
+  }
+}
+
+static void painel_dado(mock_painel_t *p, uint8_t d)
+{
+  p->gddram[p->pagina][p->coluna] = d;
+  p->dados++;
+  if (p->modo == 1) {
+    if (++p->pagina > p->p1) {
+      p->pagina = p->p0;
+      if (++p->coluna > p->c1)
+        p->coluna = p->c0;
+    }
+  } else if (p->modo == 0) {
+    if (++p->coluna > p->c1) {
+      p->coluna = p->c0;
+      if (++p->pagina > p->p1)
+        p->pagina = p->p0;
+    }
+  } else {
+    p->coluna = (p->coluna + 1) & 127;
+  }
+}
+
+// Uma transação: bytes de controle (Co, D/C) seguidos de comandos ou dados
+static void painel_recebe(mock_painel_t *p, const uint8_t *b, size_t n)
+{
+  size_t k = 0;
+  while (k < n) {
+    uint8_t controle = b[k++];
+    size_t fim = (controle & 0x80) && k < n ? k + 1 : n;
+    for (; k < fim; k++) {
+      if (controle & 0x40)
+        painel_dado(p, b[k]);
+      else
+        painel_comando(p, b[k]);
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// I2C
+
+static i2c_hw_t i2c_hw[NUM_I2CS] = { { .status = I2C_IC_STATUS_TFE_BITS }, { .status = I2C_IC_STATUS_TFE_BITS } };
+i2c_inst_t i2c0_inst = { &i2c_hw[0], false };
+i2c_inst_t i2c1_inst = { &i2c_hw[1], false };
+static uint baud[NUM_I2CS] = { 100000, 100000 };
+static mock_barramento_t barramentos[NUM_I2CS];
+static mock_transacao_t *registro = NULL;
+static size_t registrados = 0, capacidade = 0;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+  baud[i2c_get_index(i2c)] = baudrate;
+  i2c->hw->enable = 1;
+  return baudrate;
+}
+
+uint i2c_get_index(i2c_inst_t *i2c)
+{
+  return i2c == i2c1 ? 1 : 0;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c)
+{
+  return i2c->hw;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx)
+{
+  return 32 + 2 * i2c_get_index(i2c) + !is_tx;
+}
+
+mock_barramento_t *mock_barramento(uint indice)
+{
+  return &barramentos[indice];
+}
+
+size_t mock_transacoes(const mock_transacao_t **r)
+{
+  *r = registro;
+  return registrados;
+}
+
+// Tempo no fio: 9 bits (8 + ACK) por byte, incluindo o de endereço
+static uint64_t i2c_duracao_us(uint b, size_t bytes)
+{
+  return ((uint64_t)bytes * 9 * 1000000 + baud[b] - 1) / baud[b];
+}
+
+static void i2c_registra(uint b, uint8_t endereco, bool dma, size_t bytes, uint64_t inicio, uint64_t fim)
+{
+  if (registrados == capacidade) {
+    capacidade = capacidade ? 2 * capacidade : 256;
+    registro = realloc(registro, capacidade * sizeof(*registro));
+  }
+  registro[registrados++] = (mock_transacao_t){ b, endereco, dma, bytes, inicio, fim };
+  barramentos[b].transacoes++;
+  barramentos[b].bytes += bytes;
+  barramentos[b].ocupado_us += fim - inicio;
+}
+
+// ---------------------------------------------------------------------------------------
+// PIO
+
+typedef struct {
+  bool usada;
+  pio_sm_config config;
+  uint32_t *palavras;
+  size_t total, capacidade;
+} mock_sm_t;
+
+pio_hw_t pio0_hw, pio1_hw;
+static mock_sm_t sms[2][NUM_PIO_STATE_MACHINES];
+
+static mock_sm_t *sm_de(PIO pio, uint sm)
+{
+  return &sms[pio == pio1][sm];
+}
+
+static void pio_fifo_put(mock_sm_t *s, uint32_t palavra)
+{
+  if (s->total == s->capacidade) {
+    s->capacidade = s->capacidade ? 2 * s->capacidade : 256;
+    s->palavras = realloc(s->palavras, s->capacidade * sizeof(uint32_t));
+  }
+  s->palavras[s->total++] = palavra;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+  (void)pio;
+  (void)program;
+  return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+  for (uint i = 0; i < NUM_PIO_STATE_MACHINES; i++) {
+    if (!sm_de(pio, i)->usada) {
+      sm_de(pio, i)->usada = true;
+      return i;
+    }
+  }
+  if (required)
+    falha("sem state machine livre");
+  return -1;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx)
+{
+  return (pio == pio1 ? 8 : 0) + sm + (is_tx ? 0 : 4);
+}
+
+void pio_gpio_init(PIO pio, uint pin)
+{
+  gpio_set_function(pin, pio == pio1 ? GPIO_FUNC_PIO1 : GPIO_FUNC_PIO0);
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out)
+{
+  (void)pio;
+  (void)sm;
+  (void)pin_base;
+  (void)pin_count;
+  (void)is_out;
+}
+
+pio_sm_config pio_get_default_sm_config(void)
+{
+  return (pio_sm_config){ .shift_right = true, .autopull = false, .pull_threshold = 32, .clkdiv = 1.0f };
+}
+
+void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base)
+{
+  c->sideset_base = sideset_base;
+}
+
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold)
+{
+  c->shift_right = shift_right;
+  c->autopull = autopull;
+  c->pull_threshold = pull_threshold;
+}
+
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join)
+{
+  c->join_tx = join == PIO_FIFO_JOIN_TX;
+}
+
+void sm_config_set_clkdiv(pio_sm_config *c, float div)
+{
+  c->clkdiv = div;
+}
+
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config)
+{
+  (void)initial_pc;
+  sm_de(pio, sm)->config = *config;
+  return 0;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+  (void)pio;
+  (void)sm;
+  (void)enabled;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+  pio_fifo_put(sm_de(pio, sm), data);
+}
+
+const pio_sm_config *mock_pio_config(PIO pio, uint sm)
+{
+  return &sm_de(pio, sm)->config;
+}
+
+size_t mock_pio_palavras(PIO pio, uint sm, const uint32_t **palavras)
+{
+  *palavras = sm_de(pio, sm)->palavras;
+  return sm_de(pio, sm)->total;
+}
+
+// Com autopull, o state machine tira pull_threshold bits de cada palavra pelo lado indicado
+// em sm_config_set_out_shift() e descarta o resto
+size_t mock_pio_bits(PIO pio, uint sm, uint8_t *bits, size_t max)
+{
+  const mock_sm_t *s = sm_de(pio, sm);
+  uint n = s->config.pull_threshold ? s->config.pull_threshold : 32;
+  size_t k = 0;
+  for (size_t i = 0; i < s->total; i++) {
+    for (uint b = 0; b < n && k < max; b++)
+      bits[k++] = s->config.shift_right ? (s->palavras[i] >> b) & 1 : (s->palavras[i] >> (31 - b)) & 1;
+  }
+  return k;
+}
+
+// ---------------------------------------------------------------------------------------
+// DMA
+
+typedef enum { DESTINO_OUTRO, DESTINO_I2C, DESTINO_PIO } destino_t;
+
+typedef struct {
+  bool usado;
+  uint32_t tamanho;                         // Bytes por transferência (1, 2 ou 4)
+  volatile void *escrita;
+  const volatile void *leitura;
+  uint32_t quantidade;
+  bool ocupado;
+  uint64_t inicio, fim;
+  uint8_t endereco;                         // IC_TAR no início da transferência (I2C)
+  bool irq0;
+  bool irq0_status;
+} canal_t;
+
+static canal_t canais[NUM_DMA_CHANNELS];
+static irq_handler_t dma_handler = NULL;
+static bool dma_irq_ligada = false;
+
+static destino_t destino(const canal_t *c, uint *indice, uint *sm)
+{
+  for (uint b = 0; b < NUM_I2CS; b++) {
+    if (c->escrita == &i2c_hw[b].data_cmd) {
+      *indice = b;
+      return DESTINO_I2C;
+    }
+  }
+  for (uint p = 0; p < 2; p++) {
+    pio_hw_t *hw = p ? pio1 : pio0;
+    for (uint i = 0; i < NUM_PIO_STATE_MACHINES; i++) {
+      if (c->escrita == &hw->txf[i]) {
+        *indice = p;
+        *sm = i;
+        return DESTINO_PIO;
+      }
+    }
+  }
+  return DESTINO_OUTRO;
+}
+
+static bool i2c_dma_ativo(uint b)
+{
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    uint indice = 0, sm = 0;
+    if (canais[ch].ocupado && destino(&canais[ch], &indice, &sm) == DESTINO_I2C && indice == b)
+      return true;
+  }
+  return false;
+}
+
+int dma_claim_unused_channel(bool required)
+{
+  for (int ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (!canais[ch].usado) {
+      canais[ch] = (canal_t){ .usado = true, .tamanho = 4 };
+      return ch;
+    }
+  }
+  if (required)
+    falha("sem canal DMA livre");
+  return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+  (void)channel;
+  return (dma_channel_config){ DMA_SIZE_32 };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+  c->ctrl = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+  if (!incr)
+    falha("o modelo só lê a origem em sequência");
+  (void)c;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+  if (incr)
+    falha("o modelo só escreve em registradores (sem incremento)");
+  (void)c;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+  (void)c;
+  (void)dreq;
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+  canal_t *c = &canais[channel];
+  uint indice = 0, sm = 0;
+  if (c->ocupado)
+    falha("DMA disparado com o canal ocupado");
+  c->leitura = read_addr;
+  c->quantidade = transfer_count;
+  c->inicio = relogio();
+  uint64_t duracao = 0;
+  switch (destino(c, &indice, &sm)) {
+    case DESTINO_I2C:
+      if (i2c_dma_ativo(indice) || !(i2c_hw[indice].status & I2C_IC_STATUS_TFE_BITS))
+        barramentos[indice].colisoes++;
+      if (!i2c_hw[indice].enable)
+        falha("DMA para um I2C desabilitado");
+      c->endereco = i2c_hw[indice].tar & 0x7F;
+      duracao = i2c_duracao_us(indice, transfer_count + 1);
+      i2c_hw[indice].status = I2C_IC_STATUS_MST_ACTIVITY_BITS;
+      break;
+    case DESTINO_PIO:
+      // O DMA termina quando a última palavra entra na FIFO; as anteriores já saíram pelo fio
+      duracao = transfer_count > MOCK_PIO_FIFO ? (uint64_t)(transfer_count - MOCK_PIO_FIFO) * MOCK_PIO_PALAVRA_US : 0;
+      break;
+    default:
+      break;
+  }
+  c->fim = c->inicio + duracao;
+  c->ocupado = true;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+  canal_t *c = &canais[channel];
+  c->tamanho = 1u << config->ctrl;
+  c->escrita = write_addr;
+  c->leitura = read_addr;
+  c->quantidade = transfer_count;
+  if (trigger)
+    dma_channel_transfer_from_buffer_now(channel, read_addr, transfer_count);
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+  return canais[channel].ocupado;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+  canais[channel].irq0 = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+  return canais[channel].irq0_status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+  canais[channel].irq0_status = false;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+  (void)order_priority;
+  if (num != DMA_IRQ_0 || (dma_handler && dma_handler != handler))
+    falha("só um handler em DMA_IRQ_0 é modelado");
+  dma_handler = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+  if (num == DMA_IRQ_0)
+    dma_irq_ligada = enabled;
+}
+
+// Fim de uma transferência: só agora a origem é lida, como o DMA real faria ao longo dela
+static void conclui_dma(uint ch)
+{
+  canal_t *c = &canais[ch];
+  uint indice = 0, sm = 0;
+  switch (destino(c, &indice, &sm)) {
+    case DESTINO_I2C: {
+      if (c->tamanho != 2)
+        falha("IC_DATA_CMD espera palavras de 16 bits");
+      const volatile uint16_t *w = c->leitura;
+      uint8_t *bytes = malloc(c->quantidade);
+      for (uint32_t i = 0; i < c->quantidade; i++) {
+        bytes[i] = w[i] & 0xFF;
+        if ((w[i] & I2C_IC_DATA_CMD_STOP_BITS) != (i + 1 == c->quantidade ? I2C_IC_DATA_CMD_STOP_BITS : 0))
+          barramentos[indice].sem_stop++;
+      }
+      painel_recebe(painel(indice, c->endereco), bytes, c->quantidade);
+      free(bytes);
+      i2c_registra(indice, c->endereco, true, c->quantidade + 1, c->inicio, c->fim);
+      i2c_hw[indice].status = I2C_IC_STATUS_TFE_BITS;
+      break;
+    }
+    case DESTINO_PIO: {
+      if (c->tamanho != 4)
+        falha("a FIFO do PIO espera palavras de 32 bits");
+      const volatile uint32_t *w = c->leitura;
+      for (uint32_t i = 0; i < c->quantidade; i++)
+        pio_fifo_put(&sms[indice][sm], w[i]);
+      break;
+    }
+    default:
+      break;
+  }
+  c->ocupado = false;
+  if (c->irq0)
+    c->irq0_status = true;
+}
+
+static void atende_dma_irq(void)
+{
+  if (!dma_handler || !dma_irq_ligada)
+    return;
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (canais[ch].irq0_status) {
+      em_irq = true;
+      dma_handler();
+      em_irq = false;
+      canais[ch].irq0_status = false;       // Um handler que não reconhece não trava o mock
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Passagem do tempo
+
+static uint64_t proximo_evento(bool com_alarmes)
+{
+  uint64_t t = UINT64_MAX;
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    if (canais[ch].ocupado && canais[ch].fim < t)
+      t = canais[ch].fim;
+  for (int i = 0; com_alarmes && i < ALARMES_MAX; i++)
+    if (alarmes[i].estado == ALARME_PENDENTE && alarmes[i].quando < t)
+      t = alarmes[i].quando;
+  return t;
+}
+
+// Trata, em ordem, os fins de DMA e os alarmes até o instante ate. Com as interrupções
+// desabilitadas (ou já dentro de uma) só o hardware avança; alarmes e o handler do DMA
+// esperam a próxima oportunidade.
+static void processa(uint64_t ate)
+{
+  for (;;) {
+    bool permitida = irq_permitida();
+    if (permitida)
+      atende_dma_irq();
+    uint64_t t = proximo_evento(permitida);
+    if (t > ate)
+      break;
+    if (t > agora)
+      agora = t;
+    int ch = -1;
+    for (uint i = 0; i < NUM_DMA_CHANNELS && ch < 0; i++)
+      if (canais[i].ocupado && canais[i].fim <= t)
+        ch = i;
+    if (ch >= 0) {
+      conclui_dma(ch);
+      continue;
+    }
+    for (int i = 0; i < ALARMES_MAX; i++) {
+      if (alarmes[i].estado == ALARME_PENDENTE && alarmes[i].quando <= t) {
+        dispara_alarme(&alarmes[i]);
+        break;
+      }
+    }
+  }
+  if (!real && ate > agora)
+    agora = ate;
+}
+
+void mock_avanca_us(uint64_t us)
+{
+  processa(relogio() + us);
+}
+
+void mock_espera_dma(void)
+{
+  uint64_t t;
+  while ((t = proximo_evento(false)) != UINT64_MAX)
+    processa(t);
+}
+
+static void (*nucleo1_passo)(void) = NULL;
+static bool nucleo1_rodando = false;
+
+void mock_nucleo1(void (*passo)(void))
+{
+  nucleo1_passo = passo;
+}
+
+// Um passo do núcleo 1; as esperas dele mesmo não o fazem andar de novo
+static void nucleo1_anda(void)
+{
+  if (!nucleo1_passo || nucleo1_rodando)
+    return;
+  nucleo1_rodando = true;
+  nucleo1_passo();
+  nucleo1_rodando = false;
+}
+
+// Uma espera ativa do firmware: o núcleo 1 simulado dá um passo e o relógio salta até o
+// próximo evento (ou 1 us, se não houver)
+void tight_loop_contents(void)
+{
+  nucleo1_anda();
+  if (real) {
+    processa(relogio());
+    return;
+  }
+  uint64_t t = proximo_evento(irq_permitida());
+  processa(t != UINT64_MAX && t > agora ? t : agora + 1);
+}
+
+void __sev(void)
+{
+  __atomic_store_n(&sev, 1, __ATOMIC_SEQ_CST);
+}
+
+static void stdio_aguarda(uint64_t ate);
+
+void __wfe(void)
+{
+  if (__atomic_exchange_n(&sev, 0, __ATOMIC_SEQ_CST))
+    return;
+  uint64_t t = proximo_evento(irq_permitida());
+  if (real) {
+    stdio_aguarda(t);
+    processa(relogio());
+  } else {
+    if (t == UINT64_MAX)
+      falha("__wfe() sem nenhum evento pendente: o firmware dormiria para sempre");
+    processa(t > agora ? t : agora);
+  }
+  __atomic_store_n(&sev, 0, __ATOMIC_SEQ_CST);
+}
+
+uint32_t time_us_32(void)
+{
+  return (uint32_t)relogio();
+}
+
+uint64_t time_us_64(void)
+{
+  return relogio();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+  return relogio();
+}
+
+void sleep_us(uint64_t us)
+{
+  if (real)
+    usleep(us);
+  processa(relogio() + us);
+}
+
+void sleep_ms(uint32_t ms)
+{
+  sleep_us((uint64_t)ms * 1000);
+}
+
+void busy_wait_us(uint64_t us)
+{
+  sleep_us(us);
+}
+
+// ---------------------------------------------------------------------------------------
+// Escrita I2C bloqueante: espera o fim da transmissão, atendendo as interrupções no caminho
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+  (void)nostop;
+  uint b = i2c_get_index(i2c);
+  if (i2c_dma_ativo(b) || !(i2c_hw[b].status & I2C_IC_STATUS_TFE_BITS))
+    barramentos[b].colisoes++;
+  uint64_t inicio = relogio();
+  uint64_t fim = inicio + i2c_duracao_us(b, len + 1);
+  painel_recebe(painel(b, addr), src, len);
+  i2c_registra(b, addr, false, len + 1, inicio, fim);
+  if (!real)
+    processa(fim);
+  return (int)len;
+}
+
+void mock_limpa_registros(void)
+{
+  registrados = 0;
+  memset(barramentos, 0, sizeof(barramentos));
+  for (int p = 0; p < 2; p++)
+    for (int i = 0; i < NUM_PIO_STATE_MACHINES; i++)
+      sms[p][i].total = 0;
+}
+
+// ---------------------------------------------------------------------------------------
+// GPIO
+
+typedef struct {
+  bool saida;                               // gpio_set_dir(GPIO_OUT)
+  bool valor;                               // gpio_put()
+  int externo;                              // Nível imposto pelo teste (-1: solto)
+  bool pull_up, pull_down;
+  uint32_t irq;
+} pino_t;
+
+static pino_t pinos[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_callback = NULL;
+
+static void pinos_init(void)
+{
+  static bool pronto = false;
+  if (pronto)
+    return;
+  for (uint i = 0; i < NUM_BANK0_GPIOS; i++)
+    pinos[i].externo = -1;
+  pronto = true;
+}
+
+void gpio_init(uint gpio)
+{
+  pinos_init();
+  pinos[gpio].saida = false;
+  pinos[gpio].valor = false;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+  pinos[gpio].saida = out;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+  pinos[gpio].valor = value;
+}
+
+bool gpio_get(uint gpio)
+{
+  pinos_init();
+  const pino_t *p = &pinos[gpio];
+  if (p->saida)
+    return p->valor;
+  if (p->externo >= 0)
+    return p->externo;
+  return p->pull_up;
+}
+
+void gpio_pull_up(uint gpio)
+{
+  pinos[gpio].pull_up = true;
+  pinos[gpio].pull_down = false;
+}
+
+void gpio_pull_down(uint gpio)
+{
+  pinos[gpio].pull_down = true;
+  pinos[gpio].pull_up = false;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+  (void)gpio;
+  (void)fn;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+  if (enabled)
+    pinos[gpio].irq |= event_mask;
+  else
+    pinos[gpio].irq &= ~event_mask;
+  gpio_callback = callback;
+}
+
+void mock_gpio_nivel(uint gpio, bool nivel)
+{
+  pinos_init();
+  bool antes = gpio_get(gpio);
+  pinos[gpio].externo = nivel;
+  if (antes == nivel)
+    return;
+  uint32_t borda = nivel ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+  if (gpio_callback && (pinos[gpio].irq & borda) && !em_irq) {
+    em_irq = true;
+    gpio_callback(gpio, borda);
+    em_irq = false;
+  }
+}
+
+bool mock_gpio_saida(uint gpio)
+{
+  return pinos[gpio].valor;
+}
+
+// ---------------------------------------------------------------------------------------
+// Serial: fila de entrada no modo virtual, stdin/stdout no modo real
+
+static uint8_t entrada[1 << 16];
+static size_t entrada_head = 0, entrada_tail = 0;
+static void (*chars_callback)(void *) = NULL;
+static void *chars_param = NULL;
+static bool entrada_fim = false;
+static uint pacote = 0;                     // Bytes já lidos do stdin nesta chamada do callback
+
+bool stdio_init_all(void)
+{
+  return true;
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param)
+{
+  chars_callback = fn;
+  chars_param = param;
+}
+
+static void chars_disponiveis(void)
+{
+  if (chars_callback && !em_irq) {
+    em_irq = true;
+    pacote = 0;
+    chars_callback(chars_param);
+    em_irq = false;
+  }
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+  if (real) {
+    // Como a USB, entrega no máximo um pacote por aviso; o resto gera outro aviso
+    uint8_t c;
+    if (pacote == MOCK_USB_PACOTE)
+      return PICO_ERROR_TIMEOUT;
+    ssize_t n = read(STDIN_FILENO, &c, 1);
+    if (n == 1) {
+      pacote++;
+      return c;
+    }
+    if (n == 0 || (n < 0 && errno != EAGAIN))
+      entrada_fim = true;
+    return PICO_ERROR_TIMEOUT;
+  }
+  if (entrada_tail == entrada_head) {
+    if (timeout_us)
+      processa(relogio() + timeout_us);
+    return PICO_ERROR_TIMEOUT;
+  }
+  return entrada[entrada_tail++ & (sizeof(entrada) - 1)];
+}
+
+void mock_entrada(const void *dados, size_t n)
+{
+  const uint8_t *b = dados;
+  if (entrada_head - entrada_tail + n > sizeof(entrada))
+    falha("entrada da serial cheia");
+  for (size_t i = 0; i < n; i++)
+    entrada[entrada_head++ & (sizeof(entrada) - 1)] = b[i];
+  chars_disponiveis();
+}
+
+// Modo real: dorme no stdin até o próximo evento. Fim da entrada encerra o programa.
+static void stdio_aguarda(uint64_t ate)
+{
+  struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+  int espera = -1;
+  if (ate != UINT64_MAX)
+    espera = ate > relogio() ? (int)((ate - agora + 999) / 1000) : 0;
+  if (poll(&pfd, 1, espera) > 0)
+    chars_disponiveis();
+  if (entrada_fim || (pfd.revents & (POLLHUP | POLLERR) && !(pfd.revents & POLLIN)))
+    exit(0);
+}
+
+void mock_tempo_real(bool r)
+{
+  real = r;
+  if (real) {
+    base_real = monotonico_us() - agora;
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    setvbuf(stdout, NULL, _IONBF, 0);
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Travas, núcleos e relógios
+
+static spin_lock_t travas[NUM_SPIN_LOCKS];
+static uint32_t travas_usadas = 0;
+
+int spin_lock_claim_unused(bool required)
+{
+  for (int i = 0; i < NUM_SPIN_LOCKS; i++) {
+    if (!(travas_usadas & (1u << i))) {
+      travas_usadas |= 1u << i;
+      return i;
+    }
+  }
+  if (required)
+    falha("sem spin lock livre");
+  return -1;
+}
+
+spin_lock_t *spin_lock_instance(uint lock_num)
+{
+  return &travas[lock_num];
+}
+
+// Trava de verdade entre threads; no mesmo fluxo, tentar de novo seria um deadlock
+uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+  uint32_t status = save_and_disable_interrupts();
+  for (uint64_t tentativas = 0; __atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE); tentativas++)
+    if (tentativas > (1ull << 32))
+      falha("spin lock nunca liberado");
+  return status;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+  __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+  restore_interrupts(saved_irq);
+}
+
+// O laço do núcleo 1 nunca retorna; só mock_nucleo1() o faz andar
+void multicore_launch_core1(void (*entry)(void))
+{
+  (void)entry;
+  if (!nucleo1_passo)
+    falha("núcleo 1 sem passo simulado (mock_nucleo1) ou compile com MODO_DUAL_CORE 0");
+}
+
+void queue_init(queue_t *q, uint element_size, uint element_count)
+{
+  q->data = calloc(element_count, element_size);
+  q->element_size = element_size;
+  q->element_count = element_count;
+  q->head = q->tail = 0;
+}
+
+bool queue_try_add(queue_t *q, const void *data)
+{
+  if (q->head - q->tail == q->element_count)
+    return false;
+  memcpy(q->data + (q->head++ % q->element_count) * q->element_size, data, q->element_size);
+  return true;
+}
+
+void queue_add_blocking(queue_t *q, const void *data)
+{
+  while (!queue_try_add(q, data)) {
+    uint32_t nivel = queue_get_level(q);
+    nucleo1_anda();
+    if (queue_get_level(q) == nivel)
+      falha("fila cheia sem consumidor");
+  }
+}
+
+bool queue_try_remove(queue_t *q, void *data)
+{
+  if (q->head == q->tail)
+    return false;
+  memcpy(data, q->data + (q->tail++ % q->element_count) * q->element_size, q->element_size);
+  return true;
+}
+
+void queue_remove_blocking(queue_t *q, void *data)
+{
+  if (!queue_try_remove(q, data))
+    falha("fila vazia sem produtor");
+}
+
+uint queue_get_level(queue_t *q)
+{
+  return q->head - q->tail;
+}
+
+systick_hw_t mock_systick;
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+  return clk_index == clk_sys ? 125000000 : 12000000;
+}
+
+// ---------------------------------------------------------------------------------------
+// Memória
+
+// Fim do heap no linker script da Pico, lido pelo relatório de RELATORIO_RECURSOS. No
+// computador o malloc não para aqui: o símbolo só deixa o relatório compilar, e os bytes
+// livres que ele imprime não têm significado.
+char __StackLimit;
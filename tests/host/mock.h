@@ -0,0 +1,85 @@
+// Modelo do hardware usado pelos testes no computador. O firmware é compilado sem alterações
+// sobre os headers de tests/host/sdk, e este arquivo expõe o que os testes observam:
+//
+//  - relógio virtual em microssegundos, avançado só por mock_avanca_us(), pelas esperas do
+//    firmware (tight_loop_contents(), __wfe(), sleep_*) e pelo tempo das escritas I2C; os
+//    alarmes e os fins de DMA são tratados em ordem, como interrupções;
+//  - um SSD1306 por endereço em cada controlador I2C, com a GDDRAM e os registradores
+//    decodificados das escritas bloqueantes e do DMA em IC_DATA_CMD;
+//  - contadores e registro de cada transação I2C (bytes, início e fim no relógio virtual);
+//  - a configuração de cada state machine do PIO e as palavras entregues à FIFO;
+//  - níveis dos GPIO, com as interrupções de borda, e a entrada da serial.
+#pragma once
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+
+#define MOCK_PAINEIS 8                      // Displays modelados (endereços distintos)
+#define MOCK_PIO_FIFO 8                     // Palavras na FIFO de transmissão unida
+#define MOCK_PIO_PALAVRA_US 30              // Um LED WS2812 (24 bits a 800 kHz)
+#define MOCK_USB_PACOTE 64                  // Bytes da serial por aviso no modo real
+
+// Relógio
+void mock_avanca_us(uint64_t us);           // Avança tratando alarmes e DMA no caminho
+void mock_espera_dma(void);                 // Avança até não haver transferência em andamento
+void mock_tempo_real(bool real);            // Relógio real e serial no stdin/stdout (loopback)
+
+// Displays. As coordenadas de mock_painel_pixel() são as do driver: o remapeamento de
+// segmentos e a direção dos COM, fixos na configuração, não são aplicados.
+typedef struct {
+  uint8_t barramento, endereco;
+  uint8_t gddram[8][128];
+  bool ligado;                              // SET_DISP
+  uint8_t modo;                             // SET_MEM_ADDR: 0 horizontal, 1 vertical, 2 página
+  uint8_t mux;                              // SET_MUX_RATIO: linhas exibidas - 1
+  uint8_t com_pins;                         // SET_COM_PIN_CFG
+  uint8_t bomba;                            // SET_CHARGE_PUMP
+  uint8_t precarga;                         // SET_PRECHARGE
+  uint8_t start_line;                       // SET_DISP_START_LINE
+  uint32_t comandos;                        // Comandos recebidos (sem contar argumentos)
+  uint32_t dados;                           // Bytes escritos na GDDRAM
+  // Endereçamento em andamento
+  uint8_t c0, c1, p0, p1, coluna, pagina;
+  uint8_t cmd, args[6], nargs, faltam;
+} mock_painel_t;
+
+mock_painel_t *mock_painel(i2c_inst_t *i2c, uint8_t endereco);     // NULL se nunca endereçado
+bool mock_painel_pixel(const mock_painel_t *p, uint x, uint y);     // Pixel como aparece na tela
+
+// Barramentos
+typedef struct {
+  uint32_t transacoes;
+  uint32_t bytes;                           // Inclui o byte de endereço de cada transação
+  uint64_t ocupado_us;                      // Tempo total com o barramento transmitindo
+  uint32_t colisoes;                        // Escritas iniciadas com outra ainda em andamento
+  uint32_t sem_stop;                        // Transferências do DMA sem STOP na última palavra
+} mock_barramento_t;
+
+typedef struct {
+  uint8_t barramento, endereco;
+  bool dma;
+  uint32_t bytes;
+  uint64_t inicio, fim;
+} mock_transacao_t;
+
+mock_barramento_t *mock_barramento(uint indice);
+size_t mock_transacoes(const mock_transacao_t **registro);
+
+// PIO: configuração aplicada por pio_sm_init() e palavras que chegaram à FIFO
+const pio_sm_config *mock_pio_config(PIO pio, uint sm);
+size_t mock_pio_palavras(PIO pio, uint sm, const uint32_t **palavras);
+size_t mock_pio_bits(PIO pio, uint sm, uint8_t *bits, size_t max);  // Bits no fio, em ordem
+
+// Zera contadores, o registro de transações e as palavras do PIO (o estado dos displays fica)
+void mock_limpa_registros(void);
+
+// Núcleo 1. O laço infinito passado a multicore_launch_core1() não roda; o teste registra um
+// passo (ex.: um lote de comandos), chamado a cada espera ativa do núcleo 0 e quando a fila
+// entre os núcleos está cheia, como se o núcleo 1 andasse enquanto o 0 espera.
+void mock_nucleo1(void (*passo)(void));
+
+// GPIO e serial
+void mock_gpio_nivel(uint gpio, bool nivel);    // Nível imposto por fora; gera as bordas
+bool mock_gpio_saida(uint gpio);                // Último gpio_put()
+void mock_entrada(const void *dados, size_t n); // Bytes recebidos; chama o callback do stdio
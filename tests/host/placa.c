@@ -0,0 +1,13 @@
+// O firmware inteiro sobre o mock com relógio real, usando stdin e stdout como a serial USB.
+// Com um pseudo-terminal no lugar da porta, tools/protocolo.py conversa com ele como com a
+// placa (ver loopback.py). Termina quando a entrada se fecha.
+#include "mock.h"                           // Antes do firmware, que define `endereco`
+#define main firmware_main
+#include "UART_Matriz_Texto.c"
+#undef main
+
+int main(void)
+{
+  mock_tempo_real(true);
+  return firmware_main();
+}
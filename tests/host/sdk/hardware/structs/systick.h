@@ -0,0 +1,15 @@
+#pragma once
+#include "pico/types.h"
+
+typedef struct {
+  volatile uint32_t csr;
+  volatile uint32_t rvr;
+  volatile uint32_t cvr;
+  volatile uint32_t calib;
+} systick_hw_t;
+
+extern systick_hw_t mock_systick;
+#define systick_hw (&mock_systick)
+
+#define M0PLUS_SYST_CSR_CLKSOURCE_BITS 0x00000004u
+#define M0PLUS_SYST_CSR_ENABLE_BITS 0x00000001u
@@ -0,0 +1,24 @@
+// Barreiras, eventos e travas. __dmb() é uma barreira real, para que as filas sem trava
+// possam ser exercitadas com threads; as interrupções e spin locks são simulados em mock.c.
+#pragma once
+#include "pico/types.h"
+
+typedef volatile uint32_t spin_lock_t;
+
+#define NUM_SPIN_LOCKS 32
+
+static inline void __dmb(void)
+{
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void __sev(void);
+void __wfe(void);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+int spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_instance(uint lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
@@ -0,0 +1,4 @@
+#pragma once
+#include "pico/types.h"
+
+void multicore_launch_core1(void (*entry)(void));
@@ -0,0 +1,20 @@
+// Substituto do pico/stdlib.h para compilar o firmware no computador. Só declara o que o
+// firmware usa; as funções são implementadas em tests/host/mock.c.
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define PICO_ERROR_TIMEOUT (-1)
+
+void tight_loop_contents(void);
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
@@ -0,0 +1,17 @@
+// Fila entre núcleos. No mock só há um núcleo: a remoção bloqueante de uma fila vazia aborta.
+#pragma once
+#include "pico/types.h"
+
+typedef struct {
+  uint8_t *data;
+  uint element_size;
+  uint element_count;
+  uint head, tail;
+} queue_t;
+
+void queue_init(queue_t *q, uint element_size, uint element_count);
+void queue_add_blocking(queue_t *q, const void *data);
+bool queue_try_add(queue_t *q, const void *data);
+void queue_remove_blocking(queue_t *q, void *data);
+bool queue_try_remove(queue_t *q, void *data);
+uint queue_get_level(queue_t *q);
@@ -0,0 +1,86 @@
+// Animações da matriz interrompidas no meio: a nova transição parte do quadro que estava
+// aceso, mesmo que seja uma mistura de um fade, e não do último quadro-chave completo. Um
+// quadro com as mesmas intensidades só deixa de ser enviado se a cor também for a mesma.
+#include "teste.h"
+#include "matriz.h"
+#include "matriz_gamma.h"
+#include "animacao.h"
+
+#define LED_PIN 7
+#define PASSOS 8
+
+static const uint32_t aceso[] = { 0x1FFFFFF };
+static const uint32_t apagado[] = { 0 };
+static const anim_sequencia_t acende = { aceso, 1, ANIM_FADE, PASSOS, 0 };
+static const anim_sequencia_t apaga = { apagado, 1, ANIM_FADE, PASSOS, 0 };
+
+// Verde (depois da gama) enviado a todos os LEDs no último quadro; -1 se diferem
+static int verde(void)
+{
+  const uint32_t *p;
+  size_t n = mock_pio_palavras(pio0, 0, &p);
+  if (n < LED_COUNT)
+    return -1;
+  uint8_t g = p[n - LED_COUNT] >> 24;
+  for (uint i = 1; i < LED_COUNT; i++)
+    if (p[n - LED_COUNT + i] >> 24 != g)
+      return -1;
+  return g;
+}
+
+static int tick(void)
+{
+  animacao_tick();
+  mock_espera_dma();
+  return verde();
+}
+
+int main(void)
+{
+  npInit(LED_PIN);
+  npSetBrightness(255);
+
+  // Metade do fade de acender: 255 * k / PASSOS
+  animacao_inicia(&acende, 255, 255, 255);
+  int meio = 0;
+  for (uint k = 1; k <= PASSOS / 2; k++)
+    meio = tick();
+  VERIFICA_IGUAL(meio, matriz_gamma[255 * (PASSOS / 2) / PASSOS]);
+  VERIFICA(animacao_ativa());
+
+  // Apagar agora: o primeiro quadro está perto da mistura, sem voltar ao quadro-chave
+  // anterior (apagado), e daí desce até zero
+  animacao_inicia(&apaga, 255, 255, 255);
+  int atual = tick();
+  VERIFICA_IGUAL(atual, matriz_gamma[255 * (PASSOS / 2) / PASSOS * (PASSOS - 1) / PASSOS]);
+  for (uint k = 2; k <= PASSOS; k++) {
+    int proximo = tick();
+    VERIFICA(proximo >= 0 && proximo <= atual);
+    atual = proximo;
+  }
+  VERIFICA_IGUAL(atual, 0);
+  VERIFICA(!animacao_ativa());
+
+  // Depois de animacao_para() a matriz é de quem chamou: o próximo início parte do vazio
+  animacao_inicia(&acende, 255, 255, 255);
+  tick();
+  animacao_para();
+  animacao_inicia(&acende, 255, 255, 255);
+  VERIFICA_IGUAL(tick(), matriz_gamma[255 / PASSOS]);
+  animacao_para();
+
+  // Mesmo desenho em outra cor: o quadro igual em intensidade ainda tem de ser enviado
+  static const anim_sequencia_t fixo = { aceso, 1, ANIM_CORTE, 1, 0 };
+  animacao_inicia(&fixo, 255, 255, 255);
+  VERIFICA_IGUAL(tick(), matriz_gamma[255]);
+  mock_limpa_registros();
+  animacao_inicia(&fixo, 255, 0, 255);
+  VERIFICA_IGUAL(tick(), 0);
+  mock_limpa_registros();
+  animacao_inicia(&fixo, 255, 0, 255);      // Mesma cor: nada a enviar
+  const uint32_t *p;
+  VERIFICA_IGUAL(tick(), -1);
+  VERIFICA_IGUAL(mock_pio_palavras(pio0, 0, &p), 0);
+  animacao_para();
+  return teste_fim();
+}
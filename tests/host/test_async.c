@@ -0,0 +1,109 @@
+// ssd1306_send_data_async(): retorna sem esperar o barramento, o quadro em voo não muda se o
+// buffer for redesenhado, envios seguidos não se sobrepõem e o callback vem uma vez por
+// quadro transmitido. O DMA do mock só lê a origem ao fim da transferência.
+#include "teste.h"
+#include "hardware/dma.h"
+
+#define ENDERECO 0x3C
+
+static ssd1306_t ssd;
+static uint32_t concluidos = 0;
+
+static void concluido(ssd1306_t *display, void *user_data)
+{
+  VERIFICA(display == &ssd);
+  VERIFICA(!dma_channel_is_busy(display->dma_chan));
+  (*(uint32_t *)user_data)++;
+}
+
+// Padrão diferente para cada quadro k
+static void desenha(uint k)
+{
+  ssd1306_fill(&ssd, false);
+  for (uint x = 0; x < 128; x += 4)
+    ssd1306_vline(&ssd, (x + k) % 128, 0, 63, true);
+  ssd1306_draw_char(&ssd, 'A' + k, 60, 28);
+}
+
+static const mock_transacao_t *ultima(void)
+{
+  const mock_transacao_t *r;
+  size_t n = mock_transacoes(&r);
+  return n ? &r[n - 1] : NULL;
+}
+
+int main(void)
+{
+  static uint8_t quadro_a[128 * 8];
+  static mock_painel_t esperado;
+
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+  ssd1306_config(&ssd);
+  ssd1306_set_callback(&ssd, concluido, &concluidos);
+  const mock_painel_t *painel = mock_painel(i2c1, ENDERECO);
+  const mock_barramento_t *barramento = mock_barramento(i2c_get_index(i2c1));
+
+  // O envio bloqueante do quadro inteiro segura o processador pelo tempo do barramento
+  uint64_t inicio = time_us_64();
+  desenha(0);
+  ssd1306_send_data(&ssd);
+  uint64_t bloqueante = time_us_64() - inicio;
+  VERIFICA(bloqueante > 20000);
+
+  // O assíncrono só copia e dispara: o relógio não anda
+  desenha(1);
+  ssd1306_save_frame(&ssd, quadro_a);
+  inicio = time_us_64();
+  ssd1306_send_data_async(&ssd);
+  VERIFICA_IGUAL(time_us_64() - inicio, 0);
+  VERIFICA(ssd1306_busy(&ssd));
+  VERIFICA_IGUAL(concluidos, 0);
+
+  // Redesenhar durante a transmissão não altera o que chega ao display
+  desenha(2);
+  mock_espera_dma();
+  VERIFICA_IGUAL(concluidos, 1);
+  VERIFICA(!ssd1306_busy(&ssd));
+  ssd1306_load_frame(&ssd, quadro_a);
+  VERIFICA(teste_painel_igual(&ssd));
+  VERIFICA(ultima() && ultima()->dma);
+
+  // Dois quadros seguidos: o segundo espera o primeiro sair do barramento
+  mock_limpa_registros();
+  desenha(3);
+  ssd1306_send_data_async(&ssd);
+  desenha(4);
+  ssd1306_send_data_async(&ssd);
+  mock_espera_dma();
+  const mock_transacao_t *r;
+  VERIFICA_IGUAL(mock_transacoes(&r), 2);
+  VERIFICA(r[1].inicio >= r[0].fim);
+  VERIFICA_IGUAL(concluidos, 3);
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Um comando bloqueante também espera o quadro em voo
+  mock_limpa_registros();
+  desenha(5);
+  ssd1306_send_data_async(&ssd);
+  ssd1306_command(&ssd, SET_DISP | 0x01);
+  VERIFICA_IGUAL(mock_transacoes(&r), 2);
+  VERIFICA(r[0].dma && !r[1].dma && r[1].inicio >= r[0].fim);
+  VERIFICA(painel->ligado);
+  VERIFICA_IGUAL(concluidos, 4);
+
+  // Quadro idêntico ao exibido: nenhuma transação e nenhum callback
+  mock_limpa_registros();
+  memcpy(&esperado, painel, sizeof(esperado));
+  ssd1306_send_data_async(&ssd);
+  mock_espera_dma();
+  VERIFICA_IGUAL(barramento->transacoes, 0);
+  VERIFICA_IGUAL(concluidos, 4);
+  VERIFICA(memcmp(esperado.gddram, painel->gddram, sizeof(esperado.gddram)) == 0);
+
+  VERIFICA_IGUAL(barramento->colisoes, 0);
+  VERIFICA_IGUAL(barramento->sem_stop, 0);
+  printf("quadro inteiro: %llu us bloqueado com send_data, 0 us com send_data_async\n",
+         (unsigned long long)bloqueante);
+  return teste_fim();
+}
@@ -0,0 +1,144 @@
+// Debounce dos botões: sequências de bordas com repique, reproduzidas no GPIO do mock com o
+// relógio virtual, e os EVENTO_BOTAO que saem delas. Cada toque dá um único pressionado e um
+// único solto, no instante em que o sinal fica BOTAO_DEBOUNCE_MS sem bordas; pulsos curtos
+// não geram nada; segurar gera BOTAO_LONGO e depois BOTAO_REPETE a cada intervalo.
+#include "teste.h"
+#include "botoes.h"
+#include "eventos.h"
+
+#define BOTAO_A 5
+#define BOTAO_B 6
+#define MS 1000
+
+typedef struct {
+  uint8_t botao;
+  botao_acao_t acao;
+  uint32_t instante;
+} ocorrido_t;
+
+static ocorrido_t ocorridos[64];
+static uint total = 0;
+
+// Retira da fila os eventos publicados até agora
+static void coleta(void)
+{
+  evento_t ev;
+  while (evento_get(&ev)) {
+    VERIFICA_IGUAL(ev.tipo, EVENTO_BOTAO);
+    if (total < count_of(ocorridos))
+      ocorridos[total++] = (ocorrido_t){ botao_numero(ev.dado), botao_acao(ev.dado), ev.instante };
+  }
+}
+
+static void espera_us(uint64_t us)
+{
+  mock_avanca_us(us);
+  coleta();
+}
+
+// Repique: n bordas alternadas a cada passo_us, terminando no nível final
+static void repica(uint gpio, bool final, uint n, uint passo_us)
+{
+  for (uint i = 0; i < n; i++) {
+    mock_gpio_nivel(gpio, (n - 1 - i) % 2 == 0 ? final : !final);
+    espera_us(passo_us);
+  }
+}
+
+static bool ocorreu(uint i, uint8_t botao, botao_acao_t acao, uint32_t instante)
+{
+  if (i >= total)
+    return false;
+  const ocorrido_t *o = &ocorridos[i];
+  if (o->botao != botao || o->acao != acao || o->instante != instante) {
+    fprintf(stderr, "evento %u: botao %u acao %u em %u us, esperado botao %u acao %u em %u us\n", i,
+            o->botao, o->acao, o->instante, botao, acao, instante);
+    return false;
+  }
+  return true;
+}
+
+int main(void)
+{
+  evento_init();
+  mock_gpio_nivel(BOTAO_A, true);           // Soltos: pull-up
+  mock_gpio_nivel(BOTAO_B, true);
+  VERIFICA_IGUAL(botoes_adiciona(BOTAO_A), 1);
+  VERIFICA_IGUAL(botoes_adiciona(BOTAO_B), 2);
+  VERIFICA_IGUAL(botoes_adiciona(7), -1);   // Além de BOTOES_MAX
+
+  // Toque com repique de 5 bordas a cada 300 us na descida e na subida
+  espera_us(10 * MS);
+  uint32_t bordas = botao_bordas(1);
+  repica(BOTAO_A, false, 5, 300);
+  uint32_t desceu = time_us_32() - 300;     // Última borda da descida
+  espera_us(200 * MS);
+  VERIFICA(botao_pressionado(1));
+  repica(BOTAO_A, true, 5, 300);
+  uint32_t subiu = time_us_32() - 300;
+  espera_us(100 * MS);
+  VERIFICA(!botao_pressionado(1));
+  VERIFICA_IGUAL(total, 2);
+  VERIFICA(ocorreu(0, 1, BOTAO_PRESSIONADO, desceu + BOTAO_DEBOUNCE_MS * MS));
+  VERIFICA(ocorreu(1, 1, BOTAO_SOLTO, subiu + BOTAO_DEBOUNCE_MS * MS));
+  VERIFICA_IGUAL(botao_bordas(1) - bordas, 10);
+
+  // Pulso de 2 ms, menor que o debounce: nenhuma mudança aceita
+  total = 0;
+  mock_gpio_nivel(BOTAO_A, false);
+  espera_us(2 * MS);
+  mock_gpio_nivel(BOTAO_A, true);
+  espera_us(100 * MS);
+  VERIFICA_IGUAL(total, 0);
+
+  // Segurar por 1 s: longo em BOTAO_LONGO_MS contados da borda, repetições a cada
+  // BOTAO_REPETE_MS a partir daí, e nada depois de soltar
+  total = 0;
+  repica(BOTAO_B, false, 3, 500);
+  desceu = time_us_32() - 500;
+  espera_us(1000 * MS - 500);
+  repica(BOTAO_B, true, 3, 500);
+  subiu = time_us_32() - 500;
+  espera_us(500 * MS);
+  uint repeticoes = (1000 - BOTAO_LONGO_MS) / BOTAO_REPETE_MS;
+  VERIFICA_IGUAL(total, 3 + repeticoes);
+  VERIFICA(ocorreu(0, 2, BOTAO_PRESSIONADO, desceu + BOTAO_DEBOUNCE_MS * MS));
+  VERIFICA(ocorreu(1, 2, BOTAO_LONGO, desceu + BOTAO_LONGO_MS * MS));
+  for (uint i = 0; i < repeticoes; i++)
+    VERIFICA(ocorreu(2 + i, 2, BOTAO_REPETE, desceu + (BOTAO_LONGO_MS + (i + 1) * BOTAO_REPETE_MS) * MS));
+  VERIFICA(ocorreu(2 + repeticoes, 2, BOTAO_SOLTO, subiu + BOTAO_DEBOUNCE_MS * MS));
+
+  // Repique mais longo que a fila de bordas: as perdidas são contadas e o nível final vem
+  // do pino
+  total = 0;
+  bordas = botao_bordas(1);
+  repica(BOTAO_A, false, 3 * BOTAO_BORDAS + 1, 50);
+  espera_us(100 * MS);
+  VERIFICA(botao_pressionado(1));
+  VERIFICA_IGUAL(botao_bordas(1) - bordas, 3 * BOTAO_BORDAS + 1);
+  mock_gpio_nivel(BOTAO_A, true);
+  espera_us(100 * MS);
+  VERIFICA_IGUAL(total, 2);
+  VERIFICA(total == 2 && ocorridos[0].acao == BOTAO_PRESSIONADO && ocorridos[1].acao == BOTAO_SOLTO);
+
+  // Dois botões ao mesmo tempo, com repiques entrelaçados: cada um com seus eventos
+  total = 0;
+  for (uint i = 0; i < 6; i++) {
+    mock_gpio_nivel(BOTAO_A, (i + 1) % 2);
+    espera_us(200);
+    mock_gpio_nivel(BOTAO_B, (i + 1) % 2);
+    espera_us(200);
+  }
+  espera_us(100 * MS);
+  mock_gpio_nivel(BOTAO_A, true);
+  mock_gpio_nivel(BOTAO_B, true);
+  espera_us(100 * MS);
+  uint por_botao[3] = { 0 };
+  for (uint i = 0; i < total; i++)
+    por_botao[ocorridos[i].botao]++;
+  VERIFICA_IGUAL(por_botao[1], 2);
+  VERIFICA_IGUAL(por_botao[2], 2);
+  VERIFICA(!botao_pressionado(1) && !botao_pressionado(2));
+  VERIFICA_IGUAL(evento_descartados(), 0);
+  return teste_fim();
+}
@@ -0,0 +1,106 @@
+// ssd1306_draw_char_mode() copia as colunas da fonte direto nos bytes das páginas. Confere o
+// resultado contra o desenho antigo, um ssd1306_pixel() por bit, nos três modos, com y
+// alinhado e desalinhado e na borda da tela, e mede caracteres por segundo das duas formas
+// (só informativo: o tempo depende da carga da máquina).
+#include "teste.h"
+#include "font.h"
+
+static ssd1306_t rapido, referencia;
+
+// Como era antes, mais os modos: 64 chamadas de pixel por caractere
+static void ref_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, ssd1306_text_mode_t mode)
+{
+  const uint8_t *glyph = font + (font_index[(uint8_t)c] << 3);
+  for (uint8_t i = 0; i < 8; ++i)
+    for (uint8_t j = 0; j < 8; ++j) {
+      bool bit = glyph[i] & (1 << j);
+      if (mode == SSD1306_TEXT_TRANSPARENT) {
+        if (bit)
+          ssd1306_pixel(ssd, x + i, y + j, true);
+      } else {
+        ssd1306_pixel(ssd, x + i, y + j, mode == SSD1306_TEXT_INVERSE ? !bit : bit);
+      }
+    }
+}
+
+static void ref_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, ssd1306_text_mode_t mode)
+{
+  while (*str) {
+    ref_char(ssd, *str++, x, y, mode);
+    x += 8;
+    if (x + 8 >= ssd->width) {
+      x = 0;
+      y += 8;
+    }
+    if (y + 8 >= ssd->height)
+      break;
+  }
+}
+
+// Fundo com listras, para que os modos que preservam ou apagam o fundo façam diferença
+static void fundo(ssd1306_t *ssd)
+{
+  ssd1306_fill(ssd, false);
+  for (uint8_t y = 0; y < ssd->height; y += 3)
+    ssd1306_hline(ssd, 0, ssd->width - 1, y, true);
+}
+
+static bool iguais(void)
+{
+  return memcmp(rapido.ram_buffer, referencia.ram_buffer, rapido.bufsize) == 0;
+}
+
+#define CARACTERES 200000
+
+// Caracteres por segundo desenhando o alfabeto em y fixo (alinhado ou não)
+static double por_segundo(void (*desenha)(ssd1306_t *, char, uint8_t, uint8_t, ssd1306_text_mode_t),
+                          ssd1306_t *ssd, uint8_t y, ssd1306_text_mode_t mode)
+{
+  uint64_t inicio = agora_ns();
+  for (uint32_t i = 0; i < CARACTERES; i++)
+    desenha(ssd, ' ' + i % 95, (i * 8) % 120, y, mode);
+  return CARACTERES * 1e9 / (double)(agora_ns() - inicio);
+}
+
+int main(void)
+{
+  static const char *nomes[] = { "normal", "inverso", "transparente" };
+  ssd1306_init(&rapido, 128, 64, false, 0x3C, i2c1);
+  ssd1306_init(&referencia, 128, 64, false, 0x3C, i2c1);
+
+  // Todos os bytes, inclusive os que caem no glifo substituto, em todas as alturas
+  // e nas colunas da borda direita, onde o caractere é cortado
+  static const uint8_t colunas[] = { 0, 3, 60, 120, 121, 127 };
+  for (int mode = SSD1306_TEXT_NORMAL; mode <= SSD1306_TEXT_TRANSPARENT; mode++) {
+    fundo(&rapido);
+    fundo(&referencia);
+    uint falhas = 0;
+    for (uint c = 0; c < 256; c++)
+      for (uint8_t y = 0; y < 64; y++) {
+        uint8_t x = colunas[(c + y) % count_of(colunas)];
+        ssd1306_draw_char_mode(&rapido, c, x, y, mode);
+        ref_char(&referencia, c, x, y, mode);
+        if (!iguais() && falhas++ == 0) {
+          fprintf(stderr, "%s: caractere 0x%02x em (%u, %u) difere\n", nomes[mode], c, x, y);
+          VERIFICA(iguais());
+          memcpy(rapido.ram_buffer, referencia.ram_buffer, rapido.bufsize);
+        }
+      }
+
+    fundo(&rapido);
+    fundo(&referencia);
+    ssd1306_draw_string_mode(&rapido, "EMBARCATECH U4C6 - Werliarlinson 0123456789 !?.,:", 2, 5, mode);
+    ref_string(&referencia, "EMBARCATECH U4C6 - Werliarlinson 0123456789 !?.,:", 2, 5, mode);
+    VERIFICA(iguais());
+  }
+
+  printf("%-14s %-12s %14s %14s %8s\n", "modo", "y", "bytes car/s", "pixel car/s", "ganho");
+  for (int mode = SSD1306_TEXT_NORMAL; mode <= SSD1306_TEXT_TRANSPARENT; mode++)
+    for (uint8_t y = 16; y <= 21; y += 5) {
+      double novo = por_segundo(ssd1306_draw_char_mode, &rapido, y, mode);
+      double antigo = por_segundo(ref_char, &referencia, y, mode);
+      printf("%-14s %-12s %14.0f %14.0f %7.1fx\n", nomes[mode], y == 16 ? "alinhado" : "desalinhado",
+             novo, antigo, novo / antigo);
+    }
+  return teste_fim();
+}
@@ -0,0 +1,89 @@
+// Comandos em lista: a inicialização e o endereçamento de cada quadro saem numa transação
+// cada, contra uma por comando na forma antiga, e o display termina no mesmo estado.
+#include "teste.h"
+
+#define ENDERECO 0x3C
+#define OUTRO 0x3D
+
+// Sequência de ssd1306_config() para 128x64 com bomba de carga interna
+static const uint8_t inicializacao[] = {
+  SET_DISP | 0x00, SET_MEM_ADDR, 0x01, SET_DISP_START_LINE | 0x00, SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, 63, SET_COM_OUT_DIR | 0x08, SET_DISP_OFFSET, 0x00, SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80, SET_PRECHARGE, 0xF1, SET_VCOM_DESEL, 0x30, SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON, SET_NORM_INV, SET_CHARGE_PUMP, 0x14, SET_DISP | 0x01
+};
+
+static const mock_barramento_t *barramento(void)
+{
+  return mock_barramento(i2c_get_index(i2c1));
+}
+
+// Estado decodificado que a configuração define
+static bool mesmo_estado(const mock_painel_t *a, const mock_painel_t *b)
+{
+  return a->ligado == b->ligado && a->modo == b->modo && a->mux == b->mux &&
+         a->com_pins == b->com_pins && a->bomba == b->bomba && a->precarga == b->precarga &&
+         a->start_line == b->start_line && a->comandos == b->comandos;
+}
+
+int main(void)
+{
+  static ssd1306_t ssd, antigo;
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+  ssd1306_init(&antigo, 128, 64, false, OUTRO, i2c1);
+
+  // Antes: um ssd1306_command() por byte, cada um com START, endereço e STOP
+  for (size_t i = 0; i < sizeof(inicializacao); i++)
+    ssd1306_command(&antigo, inicializacao[i]);
+  VERIFICA_IGUAL(barramento()->transacoes, sizeof(inicializacao));
+  VERIFICA_IGUAL(barramento()->bytes, 3 * sizeof(inicializacao));
+  uint32_t bytes_antes = barramento()->bytes;
+
+  // Depois: a tabela inteira numa transação (endereço, 0x00 e os comandos)
+  mock_limpa_registros();
+  ssd1306_config(&ssd);
+  VERIFICA_IGUAL(barramento()->transacoes, 1);
+  VERIFICA_IGUAL(barramento()->bytes, 2 + sizeof(inicializacao));
+  VERIFICA_IGUAL(ssd.stats.transactions, 1);
+  const mock_painel_t *painel = mock_painel(i2c1, ENDERECO);
+  VERIFICA(painel && painel->ligado);
+  VERIFICA_IGUAL(painel->modo, 1);
+  VERIFICA_IGUAL(painel->mux, 63);
+  VERIFICA_IGUAL(painel->com_pins, 0x12);
+  VERIFICA_IGUAL(painel->bomba, 0x14);
+  VERIFICA(mesmo_estado(painel, mock_painel(i2c1, OUTRO)));
+  printf("inicializacao: %zu transacoes e %u bytes antes, 1 transacao e %u bytes depois\n",
+         sizeof(inicializacao), bytes_antes, barramento()->bytes);
+
+  // Quadro inteiro: janela (6 comandos) e dados, duas transações em vez de sete
+  mock_limpa_registros();
+  ssd1306_fill(&ssd, true);
+  ssd1306_send_data(&ssd);
+  VERIFICA_IGUAL(barramento()->transacoes, 2);
+  VERIFICA_IGUAL(barramento()->bytes, (1 + 1 + 6) + (1 + 1 + 1024));
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Listas maiores que o bloco de 32 comandos são divididas, cada bloco com seu 0x00
+  static uint8_t contraste[2 * 35];
+  for (size_t i = 0; i < sizeof(contraste); i += 2) {
+    contraste[i] = SET_CONTRAST;
+    contraste[i + 1] = i;
+  }
+  uint32_t comandos = painel->comandos;
+  mock_limpa_registros();
+  ssd1306_command_list(&ssd, contraste, sizeof(contraste));
+  VERIFICA_IGUAL(barramento()->transacoes, 3);
+  VERIFICA_IGUAL(barramento()->bytes, sizeof(contraste) + 3 * 2);
+  VERIFICA_IGUAL(painel->comandos, comandos + 35);
+
+  // Um comando isolado continua numa transação de 3 bytes
+  mock_limpa_registros();
+  ssd1306_command(&ssd, SET_DISP | 0x00);
+  VERIFICA_IGUAL(barramento()->transacoes, 1);
+  VERIFICA_IGUAL(barramento()->bytes, 3);
+  VERIFICA(!painel->ligado);
+
+  VERIFICA_IGUAL(barramento()->colisoes, 0);
+  return teste_fim();
+}
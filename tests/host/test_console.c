@@ -0,0 +1,134 @@
+// Console de texto com milhares de linhas: a tela, como o display a mostra (com a linha de
+// início aplicada), é sempre a das últimas linhas escritas, e cada linha nova custa no
+// barramento uma página e um comando, não um quadro inteiro. Também num painel de 32 linhas,
+// em que o anel da linha de início não fecha e o buffer é deslocado.
+#include "teste.h"
+
+#define LINHAS 5000
+#define COLUNAS 16
+
+// Modelo do texto na tela: uma linha de caracteres por página, a de baixo com o cursor
+typedef struct {
+  char texto[8][COLUNAS];
+  uint8_t linhas, coluna;
+} modelo_t;
+
+static void modelo_nova_linha(modelo_t *m)
+{
+  memmove(m->texto[0], m->texto[1], (m->linhas - 1) * COLUNAS);
+  memset(m->texto[m->linhas - 1], ' ', COLUNAS);
+  m->coluna = 0;
+}
+
+static void modelo_putc(modelo_t *m, char c)
+{
+  char *linha = m->texto[m->linhas - 1];
+  if (c == '\n') {
+    modelo_nova_linha(m);
+  } else if (c == '\r') {
+    m->coluna = 0;
+  } else if (c == '\b') {
+    if (m->coluna > 0)
+      linha[--m->coluna] = ' ';
+  } else {
+    if (m->coluna >= COLUNAS) {
+      modelo_nova_linha(m);
+      linha = m->texto[m->linhas - 1];
+    }
+    linha[m->coluna++] = c;
+  }
+}
+
+// Compara a tela exibida com o texto do modelo desenhado num buffer à parte
+static bool tela_igual(const ssd1306_t *ssd, const modelo_t *m, ssd1306_t *referencia)
+{
+  ssd1306_fill(referencia, false);
+  for (uint8_t l = 0; l < m->linhas; l++)
+    for (uint8_t c = 0; c < COLUNAS; c++)
+      ssd1306_draw_char(referencia, m->texto[l][c], c * 8, l * 8);
+  const mock_painel_t *p = mock_painel(ssd->i2c_port, ssd->address);
+  for (uint8_t y = 0; y < ssd->height; y++)
+    for (uint8_t x = 0; x < ssd->width; x++) {
+      bool esperado = referencia->ram_buffer[1 + x * referencia->pages + (y >> 3)] & (1 << (y & 7));
+      if (mock_painel_pixel(p, x, y) != esperado) {
+        fprintf(stderr, "pixel (%u, %u) da tela difere do texto esperado\n", x, y);
+        return false;
+      }
+    }
+  return true;
+}
+
+// Linha i do texto: comprimentos variados, algumas maiores que a tela (quebradas), algumas
+// com retrocesso ou retorno de carro
+static void linha(char *s, uint i)
+{
+  uint n = sprintf(s, "%u:", i);
+  uint extra = (i * 7) % 23;
+  for (uint k = 0; k < extra; k++)
+    s[n++] = 'A' + (i + k) % 26;
+  if (i % 11 == 0)
+    s[n++] = '\b';
+  if (i % 13 == 0) {
+    s[n++] = '\r';
+    s[n++] = '>';
+  }
+  s[n++] = '\n';
+  s[n] = '\0';
+}
+
+// Escreve LINHAS linhas com um flush por linha; retorna os bytes no barramento por linha
+static double escreve(ssd1306_t *ssd, ssd1306_t *referencia)
+{
+  ssd1306_console_t con;
+  modelo_t m = { .linhas = ssd->pages };
+  memset(m.texto, ' ', sizeof(m.texto));
+  ssd1306_console_init(&con, ssd);
+  ssd1306_send_data(ssd);
+
+  const mock_barramento_t *b = mock_barramento(i2c_get_index(ssd->i2c_port));
+  uint32_t bytes = b->bytes;
+  char s[64];
+  for (uint i = 0; i < LINHAS; i++) {
+    linha(s, i);
+    ssd1306_console_puts(&con, s);
+    for (const char *c = s; *c; c++)
+      modelo_putc(&m, *c);
+    ssd1306_flush(ssd);
+    if ((i % 97 == 0 || i == LINHAS - 1) && !tela_igual(ssd, &m, referencia)) {
+      fprintf(stderr, "%u linhas no painel de %u: tela errada\n", i + 1, ssd->height);
+      VERIFICA(tela_igual(ssd, &m, referencia));
+      break;
+    }
+  }
+  VERIFICA(teste_painel_igual(ssd));
+  return (double)(b->bytes - bytes) / LINHAS;
+}
+
+int main(void)
+{
+  static ssd1306_t ssd, baixo, referencia, referencia_baixo;
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&ssd, 128, 64, false, 0x3C, i2c1);
+  ssd1306_init(&baixo, 128, 32, false, 0x3D, i2c1);
+  ssd1306_init(&referencia, 128, 64, false, 0x3C, i2c0);
+  ssd1306_init(&referencia_baixo, 128, 32, false, 0x3D, i2c0);
+  ssd1306_config(&ssd);
+  ssd1306_config(&baixo);
+
+  // 64 linhas: a página que sai pelo topo é apagada e reaparece embaixo pela linha de início.
+  // Por linha vão no máximo uma página apagada, o texto novo (menos de duas páginas, com as
+  // quebras) e o comando da linha de início, cada um com sua janela
+  double por_linha = escreve(&ssd, &referencia);
+  VERIFICA(por_linha < (1 + 1 + 6) * 3 + (1 + 1 + 128) * 2 + 3);
+  VERIFICA_IGUAL(mock_painel(i2c1, 0x3C)->mux, 63);
+
+  // 32 linhas: o buffer rola e as páginas alteradas são reenviadas
+  double por_linha_baixo = escreve(&baixo, &referencia_baixo);
+  VERIFICA_IGUAL(mock_painel(i2c1, 0x3D)->mux, 31);
+  VERIFICA_IGUAL(mock_painel(i2c1, 0x3D)->start_line, 0);
+
+  VERIFICA_IGUAL(mock_barramento(i2c_get_index(i2c1))->colisoes, 0);
+  printf("%u linhas: %.1f bytes por linha no painel de 64, %.1f no de 32 (quadro inteiro: %u)\n", LINHAS,
+         por_linha, por_linha_baixo, (1 + 1 + 6) + (1 + 1 + 1024));
+  return teste_fim();
+}
@@ -0,0 +1,180 @@
+// MODO_DUAL_CORE: o firmware inteiro com o núcleo 1 simulado por core1_lote(), chamado
+// quando o teste manda ou quando o núcleo 0 espera (mock_nucleo1). Em cada lote só o último
+// comando de display e o último de matriz são desenhados, os comandos incrementais saem na
+// ordem em que chegaram (depois do que estava pendente) e envia_mensagem() só retorna depois
+// de o núcleo 1 desenhar a mensagem. As chamadas de desenho são registradas por nomes trocados
+// antes de incluir o firmware.
+#include "mock.h"                           // Antes do firmware, que define `endereco`
+#define animacao_inicia registra_animacao_inicia
+#define ssd1306_send_data_async registra_send_data_async
+#define ssd1306_flush registra_flush
+#define texto_reset registra_texto_reset
+#define texto_tick registra_texto_tick
+#define texto_fim registra_texto_fim
+#define main firmware_main
+#include "UART_Matriz_Texto.c"
+#undef main
+#undef animacao_inicia
+#undef ssd1306_send_data_async
+#undef ssd1306_flush
+#undef texto_reset
+#undef texto_tick
+#undef texto_fim
+#include "teste.h"
+
+void animacao_inicia(const anim_sequencia_t *seq, uint8_t r, uint8_t g, uint8_t b);
+void ssd1306_send_data_async(ssd1306_t *ssd);
+void ssd1306_flush(ssd1306_t *ssd);
+void texto_reset();
+void texto_tick();
+void texto_fim();
+
+// Desenhos na ordem em que o núcleo 1 os fez: 'M' matriz e 'D' display (com o caractere
+// pendente), 'I', 'T' e 'F' do modo texto, 'X' mensagem no display
+typedef struct {
+  char tipo;
+  uint8_t valor;
+} desenho_t;
+
+static desenho_t desenhos[256];
+static size_t n_desenhos;
+
+static void registra(char tipo, uint8_t valor)
+{
+  if (n_desenhos < count_of(desenhos))
+    desenhos[n_desenhos++] = (desenho_t){ tipo, valor };
+}
+
+void registra_animacao_inicia(const anim_sequencia_t *seq, uint8_t r, uint8_t g, uint8_t b)
+{
+  if (seq == &animacao_caractere)
+    VERIFICA(quadro_caractere == npGlyph(matriz_pendente.valor));
+  registra('M', seq == &animacao_caractere ? matriz_pendente.valor : 0);
+  animacao_inicia(seq, r, g, b);
+}
+
+void registra_send_data_async(ssd1306_t *s)
+{
+  registra('D', display_pendente.tipo == RENDER_PADRAO ? 0 : display_pendente.valor);
+  ssd1306_send_data_async(s);
+}
+
+void registra_flush(ssd1306_t *s)
+{
+  registra('X', 0);
+  ssd1306_flush(s);
+}
+
+void registra_texto_reset() { registra('I', 0); texto_reset(); }
+void registra_texto_tick() { registra('T', 0); texto_tick(); }
+void registra_texto_fim() { registra('F', 0); texto_fim(); }
+
+// Confere os desenhos desde a última chamada, escritos como "MB D#" ('.' para valor 0)
+static bool desenhou(const char *esperado)
+{
+  char texto[4 * count_of(desenhos) + 1] = "";
+  for (size_t i = 0; i < n_desenhos; i++)
+    sprintf(texto + strlen(texto), "%s%c%c", i ? " " : "", desenhos[i].tipo,
+            desenhos[i].valor ? desenhos[i].valor : '.');
+  n_desenhos = 0;
+  if (strcmp(texto, esperado) == 0)
+    return true;
+  fprintf(stderr, "esperado \"%s\", desenhado \"%s\"\n", esperado, texto);
+  return false;
+}
+
+// O núcleo 1: um lote com o que houver na fila
+static void passo(void)
+{
+  comando_t cmd;
+  if (queue_try_remove(&fila_render, &cmd))
+    core1_lote(cmd);
+}
+
+// Roda os dois núcleos por ms milissegundos de tempo virtual
+static void roda_ms(uint32_t ms)
+{
+  uint64_t fim = time_us_64() + (uint64_t)ms * 1000;
+  evento_t ev;
+  do {
+    while (evento_get(&ev))
+      trata_evento(&ev);
+    passo();
+    mock_avanca_us(100);
+  } while (time_us_64() < fim);
+}
+
+int main(void)
+{
+  FILE *terminal = stdout;
+  stdout = fopen("/dev/null", "w");
+  mock_gpio_nivel(button_A, true);          // Soltos (pull-up)
+  mock_gpio_nivel(button_B, true);
+  mock_nucleo1(passo);
+  inicializa();
+  roda_ms(1000);
+  mock_espera_dma();
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Um lote só com comandos de tela cheia: a matriz fica com a última letra e o display com
+  // o último caractere, cada um desenhado uma vez
+  n_desenhos = 0;
+  envia_comando(RENDER_CARACTERE, 'A', false, true);
+  envia_comando(RENDER_CARACTERE, 'B', false, true);
+  envia_comando(RENDER_CARACTERE, '#', false, true);
+  VERIFICA(desenhou(""));                   // Nada antes do núcleo 1 andar
+  passo();
+  VERIFICA(desenhou("MB D#"));
+  VERIFICA(queue_get_level(&fila_render) == 0);
+  mock_espera_dma();
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Incrementais no meio: o pendente sai antes deles, eles saem em ordem, e o que vem
+  // depois volta a ser agrupado
+  envia_comando(RENDER_CARACTERE, 'A', false, true);
+  envia_comando(RENDER_TEXTO_INICIO, 0, false, true);
+  envia_comando(RENDER_TEXTO_TICK, 0, false, true);
+  envia_comando(RENDER_TEXTO_TICK, 0, false, true);
+  envia_comando(RENDER_TEXTO_FIM, 0, false, true);
+  envia_comando(RENDER_CARACTERE, 'C', false, true);
+  envia_comando(RENDER_CARACTERE, '9', false, true);
+  envia_comando(RENDER_CARACTERE, '?', false, true);
+  passo();
+  VERIFICA(desenhou("MA DA I. T. T. F. M9 D?"));
+  mock_espera_dma();
+
+  // Fila cheia: o núcleo 0 espera o núcleo 1 esvaziá-la, sem perder o último comando
+  for (char c = 'a'; c <= 'z'; c++)
+    envia_comando(RENDER_CARACTERE, c, false, true);
+  passo();
+  VERIFICA(n_desenhos >= 4 && n_desenhos < 2 * 26);
+  VERIFICA(desenhos[n_desenhos - 2].tipo == 'M' && desenhos[n_desenhos - 2].valor == 'z');
+  VERIFICA(desenhos[n_desenhos - 1].tipo == 'D' && desenhos[n_desenhos - 1].valor == 'z');
+  n_desenhos = 0;
+  mock_espera_dma();
+
+  // envia_mensagem(): só retorna depois de o núcleo 1 desenhar a mensagem, que sai depois
+  // do caractere pendente; o buffer do analisador pode então ser reaproveitado
+  static uint8_t dados[] = { 10, 40, 'O', 'L', 'A', 0 };
+  proto_msg_t msg = { .tipo = PROTO_TEXTO, .tamanho = sizeof(dados) - 1, .dados = dados };
+  uint32_t antes = mensagens_concluidas;
+  envia_comando(RENDER_CARACTERE, 'K', false, true);
+  envia_mensagem(&msg);
+  VERIFICA_IGUAL(mensagens_concluidas, antes + 1);
+  VERIFICA(desenhou("MK DK X."));
+  VERIFICA(queue_get_level(&fila_render) == 0);
+  memset(dados, 0, sizeof(dados));
+  mock_espera_dma();
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // E a placa continua funcionando pelos eventos: um caractere pela serial
+  mock_entrada("Z", 1);
+  roda_ms(400);
+  mock_espera_dma();
+  VERIFICA(!animacao_ativa());
+  VERIFICA(teste_painel_igual(&ssd));
+
+  fclose(stdout);
+  stdout = terminal;
+  return teste_fim();
+}
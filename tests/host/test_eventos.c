@@ -0,0 +1,125 @@
+// Fila de eventos com um traço gravado: botões, recepção, timeout e fins de quadro são
+// publicados por alarmes (contexto de interrupção) nos instantes do traço, e o laço
+// principal só olha a fila a cada PERIODO_US, como se estivesse ocupado desenhando. A
+// latência de cada evento é conhecida, e a tabela de evento_dump() tem de bater com ela;
+// uma rajada maior que a fila conta os descartes.
+#include "teste.h"
+#include "eventos.h"
+
+#define PERIODO_US 1000
+
+typedef struct {
+  uint32_t instante;                        // us desde o início do traço
+  uint8_t tipo;
+  uint8_t dado;
+  uint8_t repeticoes;                       // Publicações seguidas no mesmo alarme
+} registro_t;
+
+// Traço de uma sessão: toque no botão A, texto digitado, quadros do display e da matriz,
+// uma rajada de recepção maior que a fila e o timeout de inatividade
+static const registro_t traco[] = {
+  { 150, EVENTO_BOTAO, 0x01, 1 },
+  { 1210, EVENTO_RX, 0, 1 },
+  { 1790, EVENTO_RX, 0, 1 },
+  { 2990, EVENTO_QUADRO, 0, 1 },
+  { 3005, EVENTO_QUADRO, 1, 1 },
+  { 4400, EVENTO_BOTAO, 0x11, 1 },
+  { 5001, EVENTO_RX, 0, 1 },
+  { 6420, EVENTO_QUADRO, 0, 1 },
+  { 9800, EVENTO_RX, 0, 1 },
+  { 12345, EVENTO_TIMEOUT, 0, 1 },
+  { 12346, EVENTO_QUADRO, 0, 1 },
+  { 20500, EVENTO_RX, 0, EVENTOS_MAX + 5 },
+  { 21100, EVENTO_QUADRO, 1, 1 },
+};
+
+typedef struct {
+  uint32_t n, min, max;
+  uint64_t total;
+} esperado_t;
+
+static esperado_t esperado[EVENTO_TIPOS];
+
+static int64_t publica(alarm_id_t id, void *user_data)
+{
+  const registro_t *r = user_data;
+  for (uint i = 0; i < r->repeticoes; i++)
+    evento_post(r->tipo, r->dado);
+  return 0;
+}
+
+static void espera(esperado_t *e, uint32_t us)
+{
+  if (e->n == 0 || us < e->min)
+    e->min = us;
+  if (us > e->max)
+    e->max = us;
+  e->total += us;
+  e->n++;
+}
+
+int main(void)
+{
+  evento_init();
+  uint64_t inicio = time_us_64();
+  uint32_t fim = 0;
+  for (size_t i = 0; i < count_of(traco); i++) {
+    add_alarm_in_us(traco[i].instante, publica, (void *)&traco[i], true);
+    fim = traco[i].instante;
+  }
+
+  // Latência prevista: até o próximo múltiplo de PERIODO_US; da rajada só cabe a fila
+  for (size_t i = 0; i < count_of(traco); i++) {
+    uint32_t us = (traco[i].instante / PERIODO_US + 1) * PERIODO_US - traco[i].instante;
+    uint aceitos = traco[i].repeticoes > EVENTOS_MAX ? EVENTOS_MAX : traco[i].repeticoes;
+    for (uint k = 0; k < aceitos; k++)
+      espera(&esperado[traco[i].tipo], us);
+  }
+
+  // Laço principal: confere a latência de cada evento retirado
+  uint recebidos = 0;
+  while (time_us_64() - inicio <= fim + PERIODO_US) {
+    mock_avanca_us(PERIODO_US);
+    evento_t ev;
+    while (evento_get(&ev)) {
+      uint32_t publicado = ev.instante - (uint32_t)inicio;
+      uint32_t latencia = time_us_32() - ev.instante;
+      VERIFICA_IGUAL(latencia, (publicado / PERIODO_US + 1) * PERIODO_US - publicado);
+      recebidos++;
+    }
+  }
+  VERIFICA_IGUAL(evento_descartados(), 5);
+
+  // A tabela do Ctrl+E
+  char *texto;
+  size_t tamanho;
+  FILE *terminal = stdout;
+  stdout = open_memstream(&texto, &tamanho);
+  evento_dump();
+  fclose(stdout);
+  stdout = terminal;
+
+  uint linhas = 0, total = 0;
+  for (char *linha = strtok(texto, "\r\n"); linha; linha = strtok(NULL, "\r\n")) {
+    char nome[16];
+    unsigned long n, min, media, max, descartados;
+    if (sscanf(linha, "eventos descartados (fila cheia): %lu", &descartados) == 1) {
+      VERIFICA_IGUAL(descartados, 5);
+      continue;
+    }
+    if (sscanf(linha, "%15s %lu %lu %lu %lu", nome, &n, &min, &media, &max) != 5)
+      continue;
+    const esperado_t *e = &esperado[linhas++];
+    VERIFICA_IGUAL(n, e->n);
+    VERIFICA_IGUAL(min, e->min);
+    VERIFICA_IGUAL(max, e->max);
+    VERIFICA_IGUAL(media, e->n ? e->total / e->n : 0);
+    total += n;
+  }
+  free(texto);
+  VERIFICA_IGUAL(linhas, EVENTO_TIPOS);
+  VERIFICA_IGUAL(total, recebidos);
+  VERIFICA(esperado[EVENTO_BOTAO].n && esperado[EVENTO_RX].n && esperado[EVENTO_TIMEOUT].n &&
+           esperado[EVENTO_QUADRO].n);
+  return teste_fim();
+}
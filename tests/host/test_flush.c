@@ -0,0 +1,87 @@
+// ssd1306_flush(): só as colunas alteradas vão para o barramento, e a tela termina igual ao
+// buffer. Os bytes contados são os do mock, com o de endereço de cada transação.
+#include "teste.h"
+
+#define ENDERECO 0x3C
+
+static ssd1306_t ssd;
+
+static const mock_barramento_t *barramento(void)
+{
+  return mock_barramento(i2c_get_index(i2c1));
+}
+
+int main(void)
+{
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+  ssd1306_config(&ssd);
+  ssd1306_send_data(&ssd);
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Nada alterado: nenhum byte
+  mock_limpa_registros();
+  ssd1306_flush(&ssd);
+  VERIFICA_IGUAL(barramento()->transacoes, 0);
+
+  // Um pixel: janela de uma coluna em uma página (0x00 + 6 comandos) e um byte de dados
+  mock_limpa_registros();
+  ssd1306_pixel(&ssd, 5, 10, true);
+  ssd1306_flush(&ssd);
+  VERIFICA_IGUAL(barramento()->transacoes, 2);
+  VERIFICA_IGUAL(barramento()->bytes, (1 + 1 + 6) + (1 + 1 + 1));
+  VERIFICA(mock_painel_pixel(mock_painel(i2c1, ENDERECO), 5, 10));
+  VERIFICA(teste_painel_igual(&ssd));
+
+  // Um caractere fora do alinhamento das páginas: duas páginas de no máximo 8 colunas
+  mock_limpa_registros();
+  ssd1306_draw_char(&ssd, 'W', 100, 30);
+  ssd1306_flush(&ssd);
+  VERIFICA(barramento()->bytes <= 2 * ((1 + 1 + 6) + (1 + 1 + 8)));
+  VERIFICA(teste_painel_igual(&ssd));
+  uint32_t caractere = barramento()->bytes;
+
+  // O mesmo caractere redesenhado: a região marcada não mudou e nada é enviado
+  mock_limpa_registros();
+  uint32_t evitados = ssd.stats.skipped;
+  ssd1306_draw_char(&ssd, 'W', 100, 30);
+  ssd1306_flush(&ssd);
+  VERIFICA_IGUAL(barramento()->bytes, 0);
+  VERIFICA_IGUAL(ssd.stats.skipped, evitados + 1);
+
+  // Tela inteira alterada: um único bloco (janela + 1024 bytes) em vez de 8 páginas
+  mock_limpa_registros();
+  ssd1306_fill(&ssd, true);
+  ssd1306_flush(&ssd);
+  VERIFICA_IGUAL(barramento()->transacoes, 2);
+  VERIFICA_IGUAL(barramento()->bytes, (1 + 1 + 6) + (1 + 1 + 1024));
+  VERIFICA(teste_painel_igual(&ssd));
+  uint32_t quadro = barramento()->bytes;
+
+  // Alterações aleatórias pequenas: a tela acompanha o buffer a cada flush e o tráfego fica
+  // muito abaixo de um quadro inteiro por flush
+  ssd1306_fill(&ssd, false);
+  ssd1306_flush(&ssd);
+  mock_limpa_registros();
+  const uint n = 500;
+  for (uint i = 0; i < n; i++) {
+    uint8_t x = aleatorio(128), y = aleatorio(64);
+    switch (aleatorio(4)) {
+      case 0: ssd1306_pixel(&ssd, x, y, aleatorio(2)); break;
+      case 1: ssd1306_hline(&ssd, x, x + aleatorio(12), y, aleatorio(2)); break;
+      case 2: ssd1306_vline(&ssd, x, y, y + aleatorio(12), aleatorio(2)); break;
+      case 3: ssd1306_draw_char(&ssd, ' ' + aleatorio(95), x, y); break;
+    }
+    ssd1306_flush(&ssd);
+    if (!teste_painel_igual(&ssd)) {
+      VERIFICA(teste_painel_igual(&ssd));
+      break;
+    }
+  }
+  VERIFICA(barramento()->bytes < n * quadro / 10);
+  VERIFICA_IGUAL(barramento()->colisoes, 0);
+
+  printf("caractere: %u bytes por flush, quadro inteiro: %u bytes\n", caractere, quadro);
+  printf("%u alteracoes aleatorias: %.1f bytes por flush\n", n, (double)barramento()->bytes / n);
+  return teste_fim();
+}
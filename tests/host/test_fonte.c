@@ -0,0 +1,64 @@
+// Glifos da fonte como aparecem no display, comparados com golden/fonte.txt: cada caractere
+// ASCII imprimível desenhado por ssd1306_draw_char() e lido de volta pixel a pixel, em texto
+// ('#' aceso, '.' apagado). Os bytes fora da tabela devem dar o glifo substituto.
+//
+//   test_fonte golden/fonte.txt            compara
+//   ATUALIZA_GOLDEN=1 test_fonte ...       regrava a referência
+#include "teste.h"
+#include "font.h"
+
+static ssd1306_t ssd;
+
+static bool aceso(uint8_t x, uint8_t y)
+{
+  return ssd.ram_buffer[1 + x * ssd.pages + (y >> 3)] & (1 << (y & 7));
+}
+
+// Oito linhas de oito pixels do caractere desenhado em (0, 0)
+static char *glifo(char *saida, uint8_t c)
+{
+  ssd1306_fill(&ssd, false);
+  ssd1306_draw_char(&ssd, c, 0, 0);
+  for (uint8_t y = 0; y < 8; y++) {
+    for (uint8_t x = 0; x < 8; x++)
+      *saida++ = aceso(x, y) ? '#' : '.';
+    *saida++ = '\n';
+  }
+  *saida = '\0';
+  return saida;
+}
+
+int main(int argc, char **argv)
+{
+  static char texto[96 * 90], substituto[80], outro[80];
+  if (argc < 2) {
+    fprintf(stderr, "uso: %s golden/fonte.txt\n", argv[0]);
+    return 2;
+  }
+  ssd1306_init(&ssd, 128, 64, false, 0x3C, i2c1);
+
+  char *p = texto;
+  for (uint8_t c = ' '; c <= '~'; c++) {
+    p += sprintf(p, "0x%02x '%c'\n", c, c);
+    p = glifo(p, c);
+  }
+  p += sprintf(p, "substituto\n");
+  glifo(p, 0x80);
+  VERIFICA(teste_golden(argv[1], texto));
+
+  // Todo byte fora do ASCII imprimível cai no glifo substituto, e cada imprimível tem um
+  // glifo próprio dentro de font[]
+  static bool usado[256];
+  glifo(substituto, 0x80);
+  for (uint c = 0; c < 256; c++) {
+    if (c < ' ' || c > '~') {
+      glifo(outro, c);
+      VERIFICA(strcmp(outro, substituto) == 0);
+    } else {
+      VERIFICA(!usado[font_index[c]]);
+      VERIFICA(font_index[c] < sizeof(font) / 8);
+      usado[font_index[c]] = true;
+    }
+  }
+  return teste_fim();
+}
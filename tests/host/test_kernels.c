@@ -0,0 +1,133 @@
+// Rotinas de desenho por trechos de bytes (fill, rect, hline, vline) contra as versões
+// originais, um ssd1306_pixel() por ponto: mesmo buffer e mesmas regiões sujas para entradas
+// aleatórias. O tempo de cada uma é medido no bench, não aqui.
+#include "teste.h"
+
+static ssd1306_t rapido, referencia;
+
+// Versões por pixel, como eram antes das rotinas por trechos
+static void ref_fill(ssd1306_t *ssd, bool value)
+{
+  for (uint8_t y = 0; y < ssd->height; ++y)
+    for (uint8_t x = 0; x < ssd->width; ++x)
+      ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+  for (uint8_t x = left; x < left + width; ++x) {
+    ssd1306_pixel(ssd, x, top, value);
+    ssd1306_pixel(ssd, x, top + height - 1, value);
+  }
+  for (uint8_t y = top; y < top + height; ++y) {
+    ssd1306_pixel(ssd, left, y, value);
+    ssd1306_pixel(ssd, left + width - 1, y, value);
+  }
+  if (fill)
+    for (uint8_t x = left + 1; x < left + width - 1; ++x)
+      for (uint8_t y = top + 1; y < top + height - 1; ++y)
+        ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
+{
+  for (uint8_t x = x0; x <= x1; ++x)
+    ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
+{
+  for (uint8_t y = y0; y <= y1; ++y)
+    ssd1306_pixel(ssd, x, y, value);
+}
+
+static bool iguais(void)
+{
+  return memcmp(rapido.ram_buffer, referencia.ram_buffer, rapido.bufsize) == 0 &&
+         memcmp(rapido.dirty_x0, referencia.dirty_x0, sizeof(rapido.dirty_x0)) == 0 &&
+         memcmp(rapido.dirty_x1, referencia.dirty_x1, sizeof(rapido.dirty_x1)) == 0;
+}
+
+static void limpa_sujeira(ssd1306_t *ssd)
+{
+  memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+  memset(ssd->dirty_x1, 0, sizeof(ssd->dirty_x1));
+}
+
+typedef struct {
+  uint8_t a, b, c, d;
+  bool valor, cheio;
+} args_t;
+
+typedef struct {
+  const char *nome;
+  void (*rapido)(const args_t *a, ssd1306_t *ssd);
+  void (*referencia)(const args_t *a, ssd1306_t *ssd);
+  void (*sorteia)(args_t *a);
+} rotina_t;
+
+static void sorteia_fill(args_t *a) { a->valor = aleatorio(2); }
+static void sorteia_rect(args_t *a)
+{
+  a->a = aleatorio(64);                     // topo
+  a->b = aleatorio(128);                    // esquerda
+  a->c = 1 + aleatorio(128 - a->b);         // largura
+  a->d = 1 + aleatorio(64 - a->a);          // altura
+  a->valor = aleatorio(2);
+  a->cheio = aleatorio(2);
+}
+static void sorteia_hline(args_t *a)
+{
+  a->a = aleatorio(128);
+  a->b = a->a + aleatorio(128 - a->a);
+  a->c = aleatorio(64);
+  a->valor = aleatorio(2);
+}
+static void sorteia_vline(args_t *a)
+{
+  a->a = aleatorio(128);
+  a->b = aleatorio(64);
+  a->c = a->b + aleatorio(64 - a->b);
+  a->valor = aleatorio(2);
+}
+
+static void r_fill(const args_t *a, ssd1306_t *s) { ssd1306_fill(s, a->valor); }
+static void p_fill(const args_t *a, ssd1306_t *s) { ref_fill(s, a->valor); }
+static void r_rect(const args_t *a, ssd1306_t *s) { ssd1306_rect(s, a->a, a->b, a->c, a->d, a->valor, a->cheio); }
+static void p_rect(const args_t *a, ssd1306_t *s) { ref_rect(s, a->a, a->b, a->c, a->d, a->valor, a->cheio); }
+static void r_hline(const args_t *a, ssd1306_t *s) { ssd1306_hline(s, a->a, a->b, a->c, a->valor); }
+static void p_hline(const args_t *a, ssd1306_t *s) { ref_hline(s, a->a, a->b, a->c, a->valor); }
+static void r_vline(const args_t *a, ssd1306_t *s) { ssd1306_vline(s, a->a, a->b, a->c, a->valor); }
+static void p_vline(const args_t *a, ssd1306_t *s) { ref_vline(s, a->a, a->b, a->c, a->valor); }
+
+static const rotina_t rotinas[] = {
+  { "fill", r_fill, p_fill, sorteia_fill },
+  { "rect", r_rect, p_rect, sorteia_rect },
+  { "hline", r_hline, p_hline, sorteia_hline },
+  { "vline", r_vline, p_vline, sorteia_vline },
+};
+
+int main(void)
+{
+  teste_semente = 7;
+  ssd1306_init(&rapido, 128, 64, false, 0x3C, i2c1);
+  ssd1306_init(&referencia, 128, 64, false, 0x3C, i2c1);
+
+  for (size_t r = 0; r < count_of(rotinas); r++) {
+    for (uint i = 0; i < 2000; i++) {
+      args_t a = { 0 };
+      rotinas[r].sorteia(&a);
+      limpa_sujeira(&rapido);
+      limpa_sujeira(&referencia);
+      rotinas[r].rapido(&a, &rapido);
+      rotinas[r].referencia(&a, &referencia);
+      if (!iguais()) {
+        fprintf(stderr, "%s(%u, %u, %u, %u, %u, %u) difere da versao por pixel\n", rotinas[r].nome,
+                a.a, a.b, a.c, a.d, a.valor, a.cheio);
+        VERIFICA(iguais());
+        break;
+      }
+    }
+  }
+  return teste_fim();
+}
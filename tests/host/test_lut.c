@@ -0,0 +1,92 @@
+// Gama e brilho da matriz: a tabela de gama segue a fórmula documentada em matriz_gamma.h, e
+// cada cor chega ao PIO como gama[cor] * brilho / 255 (arredondado), inclusive quando o brilho
+// muda depois de as cores serem definidas.
+#include <math.h>
+#include "teste.h"
+#include "matriz.h"
+#include "matriz_gamma.h"
+
+#define LED_PIN 7
+
+static uint8_t esperado(uint8_t cor, uint8_t brilho)
+{
+  return (matriz_gamma[cor] * brilho + 127) / 255;
+}
+
+// Palavra que chegou à FIFO para o LED i no último npWrite()
+static uint32_t palavra(uint i)
+{
+  const uint32_t *p;
+  size_t n = mock_pio_palavras(pio0, 0, &p);
+  return n >= LED_COUNT ? p[n - LED_COUNT + i] : 0;
+}
+
+static uint32_t grb(uint8_t r, uint8_t g, uint8_t b, uint8_t brilho)
+{
+  return (uint32_t)esperado(g, brilho) << 24 | (uint32_t)esperado(r, brilho) << 16 |
+         (uint32_t)esperado(b, brilho) << 8;
+}
+
+// Cor do LED i em cada quadro: os três canais diferentes e cobrindo toda a faixa
+static void cor(uint i, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+  *r = i * 255 / (LED_COUNT - 1);
+  *g = 255 - *r;
+  *b = (i * 97) & 0xFF;
+}
+
+int main(void)
+{
+  // Tabela: extremos fixos, crescente e igual a 255 * (i / 255) ^ 2.6 arredondado
+  VERIFICA_IGUAL(matriz_gamma[0], 0);
+  VERIFICA_IGUAL(matriz_gamma[255], 255);
+  for (uint i = 0; i < 256; i++) {
+    VERIFICA(i == 0 || matriz_gamma[i] >= matriz_gamma[i - 1]);
+    VERIFICA_IGUAL(matriz_gamma[i], (uint8_t)lround(255 * pow(i / 255.0, 2.6)));
+  }
+
+  npInit(LED_PIN);
+  VERIFICA_IGUAL(npGetBrightness(), NP_BRILHO_PADRAO);
+
+  static const uint8_t brilhos[] = { 255, 128, NP_BRILHO_PADRAO, 1, 0, 200 };
+  for (size_t k = 0; k < count_of(brilhos); k++) {
+    uint8_t brilho = brilhos[k];
+    npSetBrightness(brilho);
+    VERIFICA_IGUAL(npGetBrightness(), brilho);
+    for (uint i = 0; i < LED_COUNT; i++) {
+      uint8_t r, g, b;
+      cor(i, &r, &g, &b);
+      npSetLED(i, r, g, b);
+    }
+    npWrite();
+    mock_espera_dma();
+    for (uint i = 0; i < LED_COUNT; i++) {
+      uint8_t r, g, b;
+      cor(i, &r, &g, &b);
+      VERIFICA_IGUAL(palavra(i), grb(r, g, b, brilho));
+    }
+  }
+
+  // Brilho alterado sem redefinir as cores: o quadro é refeito com as cores pedidas antes
+  npSetBrightness(90);
+  npWrite();
+  mock_espera_dma();
+  for (uint i = 0; i < LED_COUNT; i++) {
+    uint8_t r, g, b;
+    cor(i, &r, &g, &b);
+    VERIFICA_IGUAL(palavra(i), grb(r, g, b, 90));
+  }
+
+  // Brilho zero apaga tudo; a volta ao brilho anterior recupera as mesmas cores
+  npSetBrightness(0);
+  npWrite();
+  mock_espera_dma();
+  for (uint i = 0; i < LED_COUNT; i++)
+    VERIFICA_IGUAL(palavra(i), 0);
+  npSetBrightness(90);
+  npWrite();
+  mock_espera_dma();
+  VERIFICA_IGUAL(palavra(LED_COUNT - 1), grb(255, 0, ((LED_COUNT - 1) * 97) & 0xFF, 90));
+
+  return teste_fim();
+}
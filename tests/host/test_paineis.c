@@ -0,0 +1,128 @@
+// Vários displays em dois barramentos: cada barramento transmite um painel por vez, os dois
+// transmitem ao mesmo tempo, o rodízio não deixa um painel sempre alterado monopolizar o
+// barramento, e atualizar tudo leva o tempo do barramento mais carregado, não a soma.
+// ssd1306_init() não aceita painéis maiores que os trechos sujos comportam.
+#include "teste.h"
+#include "paineis.h"
+
+static ssd1306_t a, b, c, d;                // a e c em i2c0; b e d em i2c1
+
+static void desenha(ssd1306_t *ssd, uint k)
+{
+  ssd1306_fill(ssd, false);
+  ssd1306_rect(ssd, k % 8, k % 16, 40, 20, true, k & 1);
+  ssd1306_draw_string(ssd, "PAINEL", 8 + k % 32, 8);
+}
+
+// Transações do DMA (quadros) registradas desde o último mock_limpa_registros()
+static size_t quadros(const mock_transacao_t **r, mock_transacao_t *saida, size_t max)
+{
+  size_t n = mock_transacoes(r), k = 0;
+  for (size_t i = 0; i < n && k < max; i++)
+    if ((*r)[i].dma)
+      saida[k++] = (*r)[i];
+  return k;
+}
+
+int main(void)
+{
+  static paineis_t pn;
+  static mock_transacao_t q[64];
+  const mock_transacao_t *r;
+
+  i2c_init(i2c0, 400 * 1000);
+  i2c_init(i2c1, 400 * 1000);
+  ssd1306_init(&a, 128, 64, false, 0x3C, i2c0);
+  ssd1306_init(&b, 128, 64, false, 0x3C, i2c1);
+  ssd1306_init(&c, 128, 32, false, 0x3D, i2c0);
+  ssd1306_init(&d, 128, 64, false, 0x3D, i2c1);
+  ssd1306_t *todos[] = { &a, &b, &c, &d };
+  paineis_init(&pn);
+  for (uint i = 0; i < count_of(todos); i++) {
+    ssd1306_config(todos[i]);
+    VERIFICA(paineis_adiciona(&pn, todos[i]));
+  }
+  static ssd1306_t repetido;
+  ssd1306_init(&repetido, 128, 64, false, 0x3D, i2c0);
+  VERIFICA(!paineis_adiciona(&pn, &repetido));  // Mesmo endereço no mesmo barramento
+
+  // Todos alterados: um quadro por painel, dois barramentos em paralelo
+  for (uint i = 0; i < count_of(todos); i++)
+    desenha(todos[i], i);
+  mock_limpa_registros();
+  uint64_t inicio = time_us_64();
+  paineis_envia(&pn);
+  uint64_t total_us = time_us_64() - inicio;
+  for (uint i = 0; i < count_of(todos); i++)
+    VERIFICA(teste_painel_igual(todos[i]));
+
+  size_t n = quadros(&r, q, count_of(q));
+  VERIFICA_IGUAL(n, 4);
+  // Ordem de registro dentro de cada barramento
+  uint8_t ordem[2][2], vistos[2] = { 0 };
+  for (size_t i = 0; i < n; i++)
+    if (vistos[q[i].barramento] < 2)
+      ordem[q[i].barramento][vistos[q[i].barramento]++] = q[i].endereco;
+  VERIFICA(vistos[0] == 2 && ordem[0][0] == 0x3C && ordem[0][1] == 0x3D);
+  VERIFICA(vistos[1] == 2 && ordem[1][0] == 0x3C && ordem[1][1] == 0x3D);
+
+  // Nenhuma sobreposição no mesmo barramento (nem entre quadros e comandos); pelo menos um
+  // quadro de cada barramento sobreposto a um do outro
+  size_t nt = mock_transacoes(&r);
+  bool paralelo = false;
+  for (size_t i = 0; i < nt; i++)
+    for (size_t j = i + 1; j < nt; j++) {
+      bool sobrepoe = r[i].inicio < r[j].fim && r[j].inicio < r[i].fim;
+      if (r[i].barramento == r[j].barramento)
+        VERIFICA(!sobrepoe);
+      else if (r[i].dma && r[j].dma && sobrepoe)
+        paralelo = true;
+    }
+  VERIFICA(paralelo);
+  VERIFICA_IGUAL(mock_barramento(0)->colisoes + mock_barramento(1)->colisoes, 0);
+
+  // Tempo total perto do barramento mais carregado e bem abaixo da soma dos dois
+  uint64_t ocupado0 = mock_barramento(0)->ocupado_us, ocupado1 = mock_barramento(1)->ocupado_us;
+  uint64_t maior = ocupado0 > ocupado1 ? ocupado0 : ocupado1;
+  VERIFICA(total_us >= maior);
+  VERIFICA(total_us < maior + maior / 10);
+  VERIFICA(total_us < (ocupado0 + ocupado1) * 3 / 4);
+  printf("4 paineis em 2 barramentos: %llu us (i2c0 %llu us, i2c1 %llu us ocupados)\n",
+         (unsigned long long)total_us, (unsigned long long)ocupado0, (unsigned long long)ocupado1);
+
+  // Rodízio: a é redesenhado a cada quadro e c também; i2c0 alterna entre os dois em vez
+  // de atender sempre o primeiro da lista
+  mock_limpa_registros();
+  for (uint k = 0; k < 6; k++) {
+    desenha(&a, 10 + k);
+    desenha(&c, 20 + k);
+    VERIFICA_IGUAL(paineis_atualiza(&pn), 1);
+    mock_espera_dma();
+  }
+  n = quadros(&r, q, count_of(q));
+  VERIFICA_IGUAL(n, 6);
+  for (size_t i = 0; i < n; i++)
+    VERIFICA(q[i].barramento == 0 && q[i].endereco == (i % 2 ? 0x3D : 0x3C));
+
+  // Painel marcado mas igual ao exibido não ocupa o barramento e não trava o rodízio
+  paineis_envia(&pn);
+  mock_limpa_registros();
+  desenha(&b, 1);                           // Redesenha o que b já exibe
+  desenha(&d, 6);
+  paineis_envia(&pn);
+  n = quadros(&r, q, count_of(q));
+  VERIFICA(n == 1 && q[0].endereco == 0x3D && q[0].barramento == 1);
+  VERIFICA(!paineis_pendentes(&pn));
+
+  // Alturas fora do suportado: limitadas a 8 * SSD1306_MAX_PAGES e a múltiplos de 8, para
+  // que os trechos sujos por página nunca sejam indexados além do fim
+  static ssd1306_t alto, torto;
+  ssd1306_init(&alto, 128, 80, false, 0x3C, i2c0);
+  VERIFICA(alto.height == 8 * SSD1306_MAX_PAGES && alto.pages == SSD1306_MAX_PAGES);
+  ssd1306_init(&torto, 128, 36, false, 0x3C, i2c0);
+  VERIFICA(torto.height == 32 && torto.pages == 4);
+  ssd1306_vline(&alto, 5, 0, 79, true);
+  ssd1306_rect(&alto, 0, 0, 128, 80, true, true);
+  VERIFICA(alto.dirty_x0[SSD1306_MAX_PAGES - 1] == 0 && alto.dirty_x1[SSD1306_MAX_PAGES - 1] == 127);
+  return teste_fim();
+}
@@ -0,0 +1,74 @@
+// Uma palavra G|R|B por LED com autopull de 24 bits: os bits que saem no fio, segundo o modelo
+// do state machine, são os mesmos da forma antiga (três palavras de 8 bits por LED, cada cor
+// em [31:24]), com um terço das escritas na FIFO.
+#include "teste.h"
+#include "matriz.h"
+#include "matriz_gamma.h"
+
+#define LED_PIN 7
+#define QUADROS 50
+
+// Bits no fio da forma antiga: pio_sm_put_blocking(cor << 24) para G, R e B, com autopull
+// de 8 bits deslocando para a esquerda, ou seja, cada byte do mais para o menos significativo
+static size_t bits_antigos(const uint8_t grb[][3], uint8_t *bits)
+{
+  size_t k = 0;
+  for (uint i = 0; i < LED_COUNT; i++)
+    for (uint c = 0; c < 3; c++) {
+      uint32_t palavra = (uint32_t)grb[i][c] << 24;
+      for (uint b = 0; b < 8; b++)
+        bits[k++] = (palavra >> (31 - b)) & 1;
+    }
+  return k;
+}
+
+int main(void)
+{
+  static uint8_t grb[LED_COUNT][3];
+  static uint8_t obtido[LED_COUNT * 24 + 1], esperado[LED_COUNT * 24];
+  teste_semente = 3;
+
+  npInit(LED_PIN);
+  npSetBrightness(255);                     // Tabela só com a gama, para montar a referência
+  const pio_sm_config *c = mock_pio_config(pio0, 0);
+  VERIFICA(c->autopull);
+  VERIFICA(!c->shift_right);
+  VERIFICA_IGUAL(c->pull_threshold, 24);
+  VERIFICA(c->join_tx);
+  VERIFICA_IGUAL(sizeof(npLED_t), 4);
+
+  uint32_t palavras = 0;
+  for (uint q = 0; q < QUADROS; q++) {
+    for (uint i = 0; i < LED_COUNT; i++) {
+      uint8_t r = aleatorio(256), g = aleatorio(256), b = aleatorio(256);
+      if (q == 0)
+        r = g = b = 0xFF;                   // Todos os bits em 1, para pegar bits perdidos
+      npSetLED(i, r, g, b);
+      grb[i][0] = matriz_gamma[g];
+      grb[i][1] = matriz_gamma[r];
+      grb[i][2] = matriz_gamma[b];
+    }
+    mock_limpa_registros();
+    npWrite();
+    mock_espera_dma();
+
+    const uint32_t *fifo;
+    VERIFICA_IGUAL(mock_pio_palavras(pio0, 0, &fifo), LED_COUNT);
+    palavras += LED_COUNT;
+    size_t n = mock_pio_bits(pio0, 0, obtido, sizeof(obtido));
+    VERIFICA_IGUAL(n, bits_antigos(grb, esperado));
+    if (memcmp(obtido, esperado, sizeof(esperado)) != 0) {
+      fprintf(stderr, "quadro %u: bits no fio diferentes da forma antiga\n", q);
+      VERIFICA(memcmp(obtido, esperado, sizeof(esperado)) == 0);
+      break;
+    }
+    // Os 8 bits baixos de cada palavra ficam fora do autopull e devem estar zerados
+    for (uint i = 0; i < LED_COUNT; i++)
+      VERIFICA_IGUAL(fifo[i] & 0xFF, 0);
+  }
+
+  VERIFICA_IGUAL(npGetStats().words, palavras);
+  printf("%u quadros: %u palavras na FIFO (%u na forma antiga), %u bits por quadro iguais\n",
+         QUADROS, palavras, 3 * palavras, LED_COUNT * 24);
+  return teste_fim();
+}
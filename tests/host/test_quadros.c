@@ -0,0 +1,170 @@
+// Analisador do protocolo binário misturado ao texto: quadros válidos de cada tipo chegam
+// inteiros; texto com 0xA5 (UTF-8) volta inteiro como caracteres, inclusive quando o 0xA5 é
+// o último byte digitado; um cabeçalho recusado não engole o quadro verdadeiro que começa
+// logo depois; CRC errado e dados interrompidos contam erro, recebem NAK e o fluxo se recupera.
+#include "teste.h"
+#include "matriz.h"
+#include "protocolo.h"
+
+static char texto[256];                     // Bytes entregues como caracteres
+static uint n_texto;
+static uint8_t tipos[16];                   // Tipos das mensagens aceitas
+static uint n_mensagens, n_nak;
+
+// Mesmo tratamento de trata_byte() no firmware: o primeiro byte devolvido é texto e os
+// demais passam de novo pelo analisador
+static void byte(uint8_t b)
+{
+  proto_msg_t msg;
+  switch (protocolo_byte(b, &msg)) {
+    case PROTO_LIVRE:
+      texto[n_texto++] = b;
+      break;
+    case PROTO_PRONTO:
+      VERIFICA_IGUAL(msg.dados[msg.tamanho], 0);
+      tipos[n_mensagens++] = msg.tipo;
+      break;
+    case PROTO_ERRO:
+      n_nak++;
+      if (msg.tamanho)
+        byte(msg.dados[0]);
+      break;
+    case PROTO_DEVOLVE: {
+      uint8_t retidos[PROTO_CABECALHO];
+      VERIFICA(msg.tamanho >= 2 && msg.tamanho <= PROTO_CABECALHO && msg.dados[0] == PROTO_SYNC);
+      memcpy(retidos, msg.dados, msg.tamanho);
+      texto[n_texto++] = retidos[0];
+      for (uint i = 1; i < msg.tamanho; i++)
+        byte(retidos[i]);
+      break;
+    }
+    case PROTO_OCUPADO:
+      break;
+  }
+}
+
+static void bytes(const void *dados, size_t n)
+{
+  for (size_t i = 0; i < n; i++) {
+    byte(((const uint8_t *)dados)[i]);
+    mock_avanca_us(100);
+  }
+}
+
+static void limpa(void)
+{
+  n_texto = n_mensagens = n_nak = 0;
+}
+
+static uint16_t crc16(const uint8_t *d, size_t n)
+{
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < n; i++) {
+    crc ^= d[i] << 8;
+    for (int k = 0; k < 8; k++)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+// Monta um quadro em q; retorna o tamanho
+static size_t quadro(uint8_t *q, uint8_t tipo, const uint8_t *dados, uint16_t n)
+{
+  q[0] = PROTO_SYNC;
+  q[1] = tipo;
+  q[2] = n & 0xFF;
+  q[3] = n >> 8;
+  memcpy(q + 4, dados, n);
+  uint16_t crc = crc16(q + 1, 3 + n);
+  q[4 + n] = crc & 0xFF;
+  q[5 + n] = crc >> 8;
+  return 6 + n;
+}
+
+int main(void)
+{
+  static uint8_t q[PROTO_MAX_DADOS + 6], dados[PROTO_MAX_DADOS];
+  for (uint i = 0; i < sizeof(dados); i++)
+    dados[i] = i * 31 + 7;
+
+  // Um quadro válido de cada tipo, entre textos
+  static const struct {
+    uint8_t tipo;
+    uint16_t tamanho;
+  } validos[] = {
+    { PROTO_MATRIZ, PROTO_TAMANHO_MATRIZ },
+    { PROTO_BLIT, PROTO_MAX_DADOS },
+    { PROTO_TEXTO, 7 },
+    { PROTO_TIMEOUT, 4 },
+    { PROTO_BRILHO, 1 },
+  };
+  for (size_t i = 0; i < count_of(validos); i++) {
+    bytes("ab", 2);
+    bytes(q, quadro(q, validos[i].tipo, dados, validos[i].tamanho));
+  }
+  VERIFICA_IGUAL(n_mensagens, count_of(validos));
+  for (size_t i = 0; i < count_of(validos); i++)
+    VERIFICA_IGUAL(tipos[i], validos[i].tipo);
+  VERIFICA_IGUAL(n_texto, 2 * count_of(validos));
+  VERIFICA_IGUAL(protocolo_erros(), 0);
+
+  // UTF-8 com 0xA5 no meio e no fim do texto: nada se perde
+  limpa();
+  const char utf8[] = "olá, språk å";   // å = C3 A5
+  bytes(utf8, strlen(utf8));
+  mock_avanca_us(PROTO_TIMEOUT_US + 1);
+  bytes("!", 1);                            // Só o próximo byte revela que o cabeçalho expirou
+  VERIFICA_IGUAL(n_texto, strlen(utf8) + 1);
+  VERIFICA(memcmp(texto, utf8, strlen(utf8)) == 0 && texto[strlen(utf8)] == '!');
+  VERIFICA_IGUAL(n_mensagens + n_nak, 0);
+
+  // Tipo válido com tamanho impossível: 'å' seguido de Ctrl+E e texto
+  limpa();
+  const uint8_t controle[] = { 0xC3, PROTO_SYNC, PROTO_BRILHO, 'o', 'k' };
+  bytes(controle, sizeof(controle));
+  VERIFICA_IGUAL(n_texto, sizeof(controle));
+  VERIFICA(memcmp(texto, controle, sizeof(controle)) == 0);
+
+  // 'å' imediatamente antes de um quadro verdadeiro: o texto e o quadro chegam
+  limpa();
+  q[0] = 0xC3;
+  q[1] = PROTO_SYNC;
+  size_t n = 2 + quadro(q + 2, PROTO_BRILHO, dados, 1);
+  bytes(q, n);
+  VERIFICA_IGUAL(n_mensagens, 1);
+  VERIFICA_IGUAL(n_texto, 2);
+  VERIFICA(n_texto == 2 && (uint8_t)texto[0] == 0xC3 && (uint8_t)texto[1] == PROTO_SYNC);
+
+  // CRC errado: NAK e erro contado; o texto seguinte volta a ser caractere
+  limpa();
+  n = quadro(q, PROTO_TEXTO, dados, 10);
+  q[n - 1] ^= 0x40;
+  bytes(q, n);
+  bytes("x", 1);
+  VERIFICA_IGUAL(n_nak, 1);
+  VERIFICA_IGUAL(protocolo_erros(), 1);
+  VERIFICA(n_texto == 1 && texto[0] == 'x');
+
+  // Quadro interrompido nos dados: abandonado pelo timeout, e o seguinte é aceito
+  limpa();
+  n = quadro(q, PROTO_BLIT, dados, 100);
+  bytes(q, 50);
+  mock_avanca_us(PROTO_TIMEOUT_US + 1);
+  bytes(q, n);
+  VERIFICA_IGUAL(n_mensagens, 1);
+  VERIFICA_IGUAL(protocolo_erros(), 2);
+  VERIFICA_IGUAL(n_nak, 1);
+  VERIFICA_IGUAL(n_texto, 0);
+
+  // Interrompido no CRC e seguido de texto: NAK quando o texto chega, que não se perde
+  limpa();
+  n = quadro(q, PROTO_TEXTO, dados, 10);
+  bytes(q, n - 1);
+  mock_avanca_us(PROTO_TIMEOUT_US + 1);
+  bytes("ok", 2);
+  VERIFICA_IGUAL(n_nak, 1);
+  VERIFICA_IGUAL(protocolo_erros(), 3);
+  VERIFICA(n_texto == 2 && memcmp(texto, "ok", 2) == 0);
+  VERIFICA_IGUAL(n_mensagens, 0);
+  return teste_fim();
+}
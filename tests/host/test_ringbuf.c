@@ -0,0 +1,105 @@
+// Fila circular da recepção: rajadas maiores que a capacidade perdem só o excesso, contado em
+// overflow, e o que entrou sai em ordem, inclusive quando os índices dão a volta em 2^32.
+// Por fim, um produtor e um consumidor em threads separadas, como a IRQ e o laço principal.
+#include <pthread.h>
+#include <sched.h>
+#include "teste.h"
+#include "ringbuf.h"
+
+#define BYTES_THREADS 1000000
+
+static ringbuf_t rb;
+
+// Rajada de n bytes numerados a partir de *seq; só os aceitos avançam a numeração
+static uint32_t rajada(uint32_t n, uint8_t *seq)
+{
+  uint32_t aceitos = 0;
+  for (uint32_t i = 0; i < n; i++)
+    if (ringbuf_put(&rb, *seq)) {
+      (*seq)++;
+      aceitos++;
+    }
+  return aceitos;
+}
+
+// Esvazia até max bytes conferindo a numeração; retorna quantos saíram
+static uint32_t drena(uint32_t max, uint8_t *seq, bool *ordem)
+{
+  uint32_t n = 0;
+  uint8_t byte;
+  while (n < max && ringbuf_get(&rb, &byte)) {
+    if (byte != (*seq)++)
+      *ordem = false;
+    n++;
+  }
+  return n;
+}
+
+static void *produtor(void *arg)
+{
+  uint8_t seq = 0;
+  uint32_t enviados = 0, rodada = 0;
+  while (enviados < BYTES_THREADS) {
+    // Rajadas de tamanhos variados, às vezes maiores que a fila inteira, separadas por pausas
+    // em que o consumidor alcança
+    while (ringbuf_count(&rb) > RINGBUF_SIZE / 4)
+      sched_yield();
+    uint32_t n = 1 + (rodada++ * 7919) % (RINGBUF_SIZE + RINGBUF_SIZE / 2);
+    for (uint32_t i = 0; i < n && enviados < BYTES_THREADS; i++, enviados++)
+      if (ringbuf_put(&rb, seq))
+        seq++;
+  }
+  __atomic_store_n((uint32_t *)arg, enviados, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+int main(void)
+{
+  uint8_t escrito = 0, lido = 0;
+  bool ordem = true;
+
+  // Rajada de uma vez e meia a capacidade sem consumidor: cabe exatamente RINGBUF_SIZE
+  VERIFICA_IGUAL(rajada(RINGBUF_SIZE + RINGBUF_SIZE / 2, &escrito), RINGBUF_SIZE);
+  VERIFICA_IGUAL(rb.overflow, RINGBUF_SIZE / 2);
+  VERIFICA_IGUAL(ringbuf_count(&rb), RINGBUF_SIZE);
+  VERIFICA_IGUAL(drena(UINT32_MAX, &lido, &ordem), RINGBUF_SIZE);
+  VERIFICA(ordem);
+  VERIFICA_IGUAL(ringbuf_count(&rb), 0);
+
+  // Produtor mais rápido que o consumidor, com os índices perto de dar a volta
+  rb.head = rb.tail = UINT32_MAX - 3000;
+  rb.overflow = 0;
+  uint32_t tentativas = 0, aceitos = 0, saidos = 0;
+  for (uint i = 0; i < 200; i++) {
+    uint32_t n = 40 + (i * 37) % 90;
+    tentativas += n;
+    aceitos += rajada(n, &escrito);
+    saidos += drena(50, &lido, &ordem);
+    VERIFICA(ringbuf_count(&rb) <= RINGBUF_SIZE);
+  }
+  VERIFICA(aceitos > 3000);                 // Os índices deram a volta
+  saidos += drena(UINT32_MAX, &lido, &ordem);
+  VERIFICA(ordem);
+  VERIFICA_IGUAL(saidos, aceitos);
+  VERIFICA_IGUAL(rb.overflow, tentativas - aceitos);
+  VERIFICA(rb.overflow > 0);
+
+  // Threads: a numeração recebida é contínua, e aceitos + descartados = enviados
+  memset(&rb, 0, sizeof(rb));
+  uint32_t enviados = 0;
+  pthread_t t;
+  pthread_create(&t, NULL, produtor, &enviados);
+  lido = 0;
+  uint32_t recebidos = 0;
+  while (!__atomic_load_n(&enviados, __ATOMIC_ACQUIRE) || ringbuf_count(&rb)) {
+    recebidos += drena(UINT32_MAX, &lido, &ordem);
+    sched_yield();                          // Com um só processador, o produtor precisa rodar
+  }
+  pthread_join(t, NULL);
+  recebidos += drena(UINT32_MAX, &lido, &ordem);
+  VERIFICA(ordem);
+  VERIFICA_IGUAL(recebidos + rb.overflow, BYTES_THREADS);
+  printf("threads: %u bytes enviados, %u recebidos em ordem, %u descartados\n", BYTES_THREADS, recebidos,
+         rb.overflow);
+  return teste_fim();
+}
@@ -0,0 +1,129 @@
+// Regressão das telas do firmware. O UART_Matriz_Texto.c é compilado inteiro (com main
+// renomeada) e conduzido pelos mesmos caminhos da placa: inicializa(), os eventos tratados por
+// trata_evento(), o alarme de inatividade (turn_off_callback), os botões pelo GPIO e os
+// caracteres pela serial. Cada tela é lida do display simulado, não do buffer, e a matriz é
+// tirada de npDumpPPM() depois de a animação terminar; tudo é comparado com golden/.
+//
+//   test_telas tests/host/golden           compara
+//   ATUALIZA_GOLDEN=1 test_telas ...       regrava as referências
+#include "mock.h"                           // Antes do firmware, que define `endereco`
+#define main firmware_main
+#include "UART_Matriz_Texto.c"
+#undef main
+#include "teste.h"
+
+static FILE *terminal;                      // stdout real; o do firmware vai para /dev/null
+static FILE *telas, *matrizes;
+
+// Roda o laço principal por ms milissegundos de tempo virtual
+static void roda_ms(uint32_t ms)
+{
+  uint64_t fim = time_us_64() + (uint64_t)ms * 1000;
+  evento_t ev;
+  do {
+    while (evento_get(&ev))
+      trata_evento(&ev);
+    mock_avanca_us(100);
+  } while (time_us_64() < fim);
+}
+
+// Registra a matriz e, se pedido, o display como aparece no painel, com o nome dado
+static void captura(const char *nome, bool tela)
+{
+  mock_espera_dma();
+  VERIFICA(!animacao_ativa());
+  VERIFICA(teste_painel_igual(&ssd));
+
+  if (tela) {
+    const mock_painel_t *p = mock_painel(I2C_PORT, endereco);
+    fprintf(telas, "P1\n# %s\n%u %u\n", nome, WIDTH, HEIGHT);
+    for (uint y = 0; y < HEIGHT; y++) {
+      for (uint x = 0; x < WIDTH; x++)
+        fputc(mock_painel_pixel(p, x, y) ? '1' : '0', telas);
+      fputc('\n', telas);
+    }
+  }
+
+  char *ppm;
+  size_t n;
+  FILE *firmware = stdout;
+  stdout = open_memstream(&ppm, &n);
+  npDumpPPM();
+  fclose(stdout);
+  stdout = firmware;
+  fprintf(matrizes, "P3\n# %s\n%s", nome, ppm + strlen("P3\n"));
+  free(ppm);
+}
+
+static void botao(uint gpio, const char *nome)
+{
+  mock_gpio_nivel(gpio, false);
+  roda_ms(100);
+  mock_gpio_nivel(gpio, true);
+  roda_ms(400);
+  captura(nome, true);
+}
+
+static void caractere(char c, bool tela)
+{
+  char nome[32];
+  mock_entrada(&c, 1);
+  roda_ms(400);
+  sprintf(nome, "caractere '%c'", c);
+  captura(nome, tela);
+}
+
+int main(int argc, char **argv)
+{
+  char caminho[512], *texto_telas, *texto_matrizes;
+  size_t n_telas, n_matrizes;
+  if (argc < 2) {
+    fprintf(stderr, "uso: %s tests/host/golden\n", argv[0]);
+    return 2;
+  }
+  terminal = stdout;
+  stdout = fopen("/dev/null", "w");
+  telas = open_memstream(&texto_telas, &n_telas);
+  matrizes = open_memstream(&texto_matrizes, &n_matrizes);
+  mock_gpio_nivel(button_A, true);          // Soltos (pull-up)
+  mock_gpio_nivel(button_B, true);
+
+  inicializa();
+  roda_ms(1000);
+  captura("tela padrao", true);
+
+  botao(button_A, "botao A: verde ligado");
+  botao(button_B, "botao B: azul ligado");
+  botao(button_A, "botao A: verde desligado");
+  botao(button_B, "botao B: azul desligado");
+  VERIFICA(!mock_gpio_saida(LED_VERDE) && !mock_gpio_saida(LED_AZUL));
+
+  // Um de cada tipo no display; todos os alfanuméricos na matriz
+  caractere('7', true);
+  caractere('K', true);
+  caractere('q', true);
+  caractere('#', true);
+  for (char c = '0'; c <= 'z'; c++)
+    if (isalnum((unsigned char)c))
+      caractere(c, false);
+
+  // Sem entrada por elapsed_time: o alarme de inatividade volta à tela padrão
+  roda_ms(elapsed_time + 1000);
+  captura("timeout", true);
+
+  fclose(telas);
+  fclose(matrizes);
+  snprintf(caminho, sizeof(caminho), "%s/telas.pbm", argv[1]);
+  VERIFICA(teste_golden(caminho, texto_telas));
+  snprintf(caminho, sizeof(caminho), "%s/matriz.ppm", argv[1]);
+  VERIFICA(teste_golden(caminho, texto_matrizes));
+
+  const mock_barramento_t *b = mock_barramento(i2c_get_index(I2C_PORT));
+  VERIFICA_IGUAL(b->colisoes, 0);
+  VERIFICA_IGUAL(b->sem_stop, 0);
+  fclose(stdout);
+  stdout = terminal;
+  printf("telas conferidas; %u transacoes I2C, %llu us de barramento\n", b->transacoes,
+         (unsigned long long)b->ocupado_us);
+  return teste_fim();
+}
@@ -0,0 +1,103 @@
+// Verificações dos testes no computador. Uma falha é contada e impressa com a linha, e o
+// teste continua; teste_fim() dá o código de saída do programa.
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mock.h"
+#ifndef SSD1306_MAX_PAGES                    // ssd1306.h não tem guarda de inclusão
+#include "ssd1306.h"
+#endif
+
+static int teste_falhas = 0;
+
+#define VERIFICA(cond)                                                                  \
+  do {                                                                                  \
+    if (!(cond)) {                                                                      \
+      fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);                \
+      teste_falhas++;                                                                   \
+    }                                                                                   \
+  } while (0)
+
+#define VERIFICA_IGUAL(obtido, esperado)                                                \
+  do {                                                                                  \
+    long long obtido_ = (long long)(obtido), esperado_ = (long long)(esperado);         \
+    if (obtido_ != esperado_) {                                                         \
+      fprintf(stderr, "%s:%d: %s = %lld, esperado %lld\n", __FILE__, __LINE__, #obtido, \
+              obtido_, esperado_);                                                      \
+      teste_falhas++;                                                                   \
+    }                                                                                   \
+  } while (0)
+
+// Relógio do computador em ns, para medições (o do mock é virtual)
+static inline uint64_t agora_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Sorteio reprodutível (xorshift32) de 0 a n - 1; cada teste pode trocar a semente no início
+static uint32_t teste_semente = 1;
+
+static inline uint32_t aleatorio(uint32_t n)
+{
+  teste_semente ^= teste_semente << 13;
+  teste_semente ^= teste_semente >> 17;
+  teste_semente ^= teste_semente << 5;
+  return teste_semente % n;
+}
+
+static inline int teste_fim(void)
+{
+  if (teste_falhas)
+    fprintf(stderr, "%d falha(s)\n", teste_falhas);
+  return teste_falhas != 0;
+}
+
+// Verdadeiro se a GDDRAM do display de ssd tem exatamente o conteúdo de ram_buffer
+static inline bool teste_painel_igual(const ssd1306_t *ssd)
+{
+  const mock_painel_t *p = mock_painel(ssd->i2c_port, ssd->address);
+  if (!p)
+    return false;
+  for (uint x = 0; x < ssd->width; x++)
+    for (uint pg = 0; pg < ssd->pages; pg++)
+      if (p->gddram[pg][x] != ssd->ram_buffer[1 + x * ssd->pages + pg])
+        return false;
+  return true;
+}
+
+// Compara o texto gerado com o arquivo de referência em tests/host/golden. Com a variável
+// ATUALIZA_GOLDEN definida o arquivo é regravado com o texto gerado, para revisão no diff.
+static inline bool teste_golden(const char *caminho, const char *obtido)
+{
+  if (getenv("ATUALIZA_GOLDEN")) {
+    FILE *f = fopen(caminho, "w");
+    if (!f || fputs(obtido, f) < 0 || fclose(f)) {
+      fprintf(stderr, "nao foi possivel gravar %s\n", caminho);
+      return false;
+    }
+    printf("%s atualizado\n", caminho);
+    return true;
+  }
+  FILE *f = fopen(caminho, "r");
+  if (!f) {
+    fprintf(stderr, "%s nao existe (gere com ATUALIZA_GOLDEN=1)\n", caminho);
+    return false;
+  }
+  uint linha = 1;
+  const char *p = obtido;
+  int c;
+  while ((c = fgetc(f)) != EOF && *p == c) {
+    if (c == '\n')
+      linha++;
+    p++;
+  }
+  fclose(f);
+  if (c == EOF && *p == '\0')
+    return true;
+  fprintf(stderr, "%s: difere na linha %u (ATUALIZA_GOLDEN=1 regrava)\n", caminho, linha);
+  return false;
+}
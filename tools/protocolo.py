@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Envia quadros do protocolo binário (inc/protocolo.h) para a placa pela serial USB.
+
+Uso:
+  protocolo.py PORTA matriz RRGGBB [RRGGBB ...]   uma cor para toda a matriz ou 25 cores
+  protocolo.py PORTA blit ARQUIVO.pbm [X PAGINA]  imagem PBM (P1 ou P4), altura múltipla de 8
+  protocolo.py PORTA texto X Y TEXTO
+  protocolo.py PORTA timeout MS
+  protocolo.py PORTA brilho VALOR                 brilho global da matriz, 0 a 255
+  protocolo.py PORTA bench [N]                    N telas inteiras e N quadros da matriz
+
+Só usa a biblioteca padrão (Linux/macOS). Cada quadro espera o ACK da placa antes do próximo.
+"""
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+
+SYNC, ACK, NAK = 0xA5, 0x06, 0x15
+MATRIZ, BLIT, TEXTO, TIMEOUT, BRILHO = 0x01, 0x02, 0x03, 0x04, 0x05
+LARGURA, ALTURA = 128, 64
+LEDS = 25
+
+
+def crc16(dados, crc=0xFFFF):
+    for byte in dados:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xFFFF
+    return crc
+
+
+def quadro(tipo, dados=b""):
+    corpo = struct.pack("<BH", tipo, len(dados)) + bytes(dados)
+    return bytes([SYNC]) + corpo + struct.pack("<H", crc16(corpo))
+
+
+class Placa:
+    def __init__(self, porta):
+        self.fd = os.open(porta, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        termios.tcflush(self.fd, termios.TCIFLUSH)
+
+    def envia(self, tipo, dados=b"", espera=2.0):
+        os.write(self.fd, quadro(tipo, dados))
+        limite = time.monotonic() + espera
+        while True:                                 # Ignora o texto que a placa imprime no meio
+            resto = limite - time.monotonic()
+            if resto <= 0 or not select.select([self.fd], [], [], resto)[0]:
+                raise TimeoutError("sem resposta da placa")
+            for byte in os.read(self.fd, 256):
+                if byte in (ACK, NAK):
+                    if byte == NAK:
+                        raise RuntimeError("quadro recusado (NAK)")
+                    return
+
+
+def le_pbm(caminho):
+    """Retorna (largura, altura, linhas de 0/1) de um PBM P1 ou P4."""
+    with open(caminho, "rb") as f:
+        dados = f.read()
+    campos, pos = [], 0
+    while len(campos) < 3:                          # Número mágico, largura e altura
+        while dados[pos:pos + 1].isspace():
+            pos += 1
+        if dados[pos:pos + 1] == b"#":
+            pos = dados.index(b"\n", pos)
+            continue
+        fim = pos
+        while not dados[fim:fim + 1].isspace():
+            fim += 1
+        campos.append(dados[pos:fim])
+        pos = fim
+    magico, w, h = campos[0], int(campos[1]), int(campos[2])
+    if magico == b"P4":
+        pos += 1
+        por_linha = (w + 7) // 8
+        return w, h, [[dados[pos + y * por_linha + x // 8] >> (7 - x % 8) & 1 for x in range(w)]
+                      for y in range(h)]
+    bits = [c - 48 for c in dados[pos:] if c in b"01"]
+    return w, h, [bits[y * w:(y + 1) * w] for y in range(h)]
+
+
+def paginas(w, h, linhas):
+    """Converte linhas de pixels para o formato do SSD1306: uma página (8 linhas) por vez."""
+    saida = bytearray()
+    for p in range(h // 8):
+        for x in range(w):
+            saida.append(sum(linhas[p * 8 + b][x] << b for b in range(8)))
+    return saida
+
+
+def blit(w, pages, dados, x=0, pagina=0):
+    return bytes([x, pagina, w, pages]) + bytes(dados)
+
+
+def bench(placa, n):
+    telas = [paginas(LARGURA, ALTURA, [[(x // 8 + y // 8 + k) & 1 for x in range(LARGURA)]
+                                       for y in range(ALTURA)]) for k in range(2)]
+    inicio = time.monotonic()
+    for i in range(n):
+        placa.envia(BLIT, blit(LARGURA, ALTURA // 8, telas[i & 1]))
+    dt = time.monotonic() - inicio
+    print(f"display: {n / dt:.1f} quadros/s ({n * (len(telas[0]) + 10) / dt / 1024:.1f} KiB/s)")
+
+    inicio = time.monotonic()
+    for i in range(n):
+        cor = bytes([(i * 7) & 0x3F, (i * 3) & 0x3F, (i * 5) & 0x3F])
+        placa.envia(MATRIZ, cor * LEDS)
+    dt = time.monotonic() - inicio
+    print(f"matriz: {n / dt:.1f} quadros/s")
+
+
+def main(args):
+    if len(args) < 2:
+        sys.exit(__doc__)
+    placa, cmd, resto = Placa(args[0]), args[1], args[2:]
+    if cmd == "matriz":
+        cores = [bytes.fromhex(c) for c in resto]
+        if len(cores) == 1:
+            cores *= LEDS
+        if len(cores) != LEDS:
+            sys.exit("informe 1 ou 25 cores")
+        placa.envia(MATRIZ, b"".join(cores))
+    elif cmd == "blit":
+        w, h, linhas = le_pbm(resto[0])
+        x, pagina = (int(resto[1]), int(resto[2])) if len(resto) > 2 else (0, 0)
+        placa.envia(BLIT, blit(w, h // 8, paginas(w, h, linhas), x, pagina))
+    elif cmd == "texto":
+        placa.envia(TEXTO, bytes([int(resto[0]), int(resto[1])]) + " ".join(resto[2:]).encode("ascii"))
+    elif cmd == "timeout":
+        placa.envia(TIMEOUT, struct.pack("<I", int(resto[0])))
+    elif cmd == "brilho":
+        placa.envia(BRILHO, bytes([int(resto[0])]))
+    elif cmd == "bench":
+        bench(placa, int(resto[0]) if resto else 100)
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])